@@ -0,0 +1,55 @@
+# Writes a C++ source with every compiled shader of the manifest as a uint32_t array, plus the table that
+# src/graphics/EmbeddedShaders.h declares. Run by the build with -DMANIFEST=<file> -DSPIRV_DIR=<dir> -DOUTPUT=<file>.
+# Each manifest line is name|stage|source|defines, and the SPIR-V is read from SPIRV_DIR/<name>.spv.
+
+file(STRINGS ${MANIFEST} entries)
+
+# CMake regexes have no {n}
+string(REPEAT "0x[0-9a-f]+, " 7 WORDS_PER_LINE)
+string(APPEND WORDS_PER_LINE "0x[0-9a-f]+,")
+
+set(arrays "")
+set(table "")
+foreach(entry ${entries})
+    if(NOT entry MATCHES "^([^|]+)\\|([^|]+)\\|([^|]+)\\|(.*)$")
+        message(FATAL_ERROR "Malformed shader manifest line: ${entry}")
+    endif()
+
+    set(name ${CMAKE_MATCH_1})
+    set(stage ${CMAKE_MATCH_2})
+    set(source ${CMAKE_MATCH_3})
+    set(defines "${CMAKE_MATCH_4}")
+
+    file(READ ${SPIRV_DIR}/${name}.spv hex HEX)
+    string(LENGTH "${hex}" hexLength)
+    math(EXPR remainder "${hexLength} % 8")
+    if(hexLength EQUAL 0 OR NOT remainder EQUAL 0)
+        message(FATAL_ERROR "${SPIRV_DIR}/${name}.spv is not SPIR-V")
+    endif()
+
+    # glslc writes little endian words
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " words "${hex}")
+    string(REGEX REPLACE "(${WORDS_PER_LINE}) " "\\1\n        " words "${words}")
+    string(STRIP "${words}" words)
+
+    string(MAKE_C_IDENTIFIER ${name} identifier)
+    string(APPEND arrays "    const uint32_t ${identifier}[] = {\n        ${words}\n    };\n\n")
+    string(APPEND table "            {\"${name}\", \"${stage}\", \"${source}\", \"${defines}\", ${identifier}, std::size(${identifier})},\n")
+endforeach()
+
+# Always rewritten: the build only runs this when a shader, the manifest or this script changed, and an untouched
+# OUTPUT would be older than its dependencies, so the step would rerun on every build
+file(WRITE ${OUTPUT}
+        "// Generated by cmake/EmbedShaders.cmake from the shaders in CMakeLists.txt. Do not edit.\n"
+        "#include \"graphics/EmbeddedShaders.h\"\n\n"
+        "#include <iterator>\n\n"
+        "namespace {\n"
+        "${arrays}"
+        "    const reina::graphics::EmbeddedShader shaders[] = {\n"
+        "${table}"
+        "    };\n"
+        "}\n\n"
+        "std::span<const reina::graphics::EmbeddedShader> reina::graphics::getEmbeddedShaders() {\n"
+        "    return shaders;\n"
+        "}\n")
+
@@ -10,13 +10,128 @@
     using mat4 = glm::mat4;
 #endif  // #ifdef __cplusplus
 
+// samples per pixel of each frame when the frame time isn't budgeted (see src/graphics/SampleScheduler.h)
 #define SAMPLES_PER_PIXEL 32
 #define BOUNCES_PER_SAMPLE 12
 
+// 1: vertex positions are stored as bounds-relative 16-bit SNORMs (8 bytes per vertex instead of 16) for both the BLAS
+// input and hit shader fetches. 0: full-precision float positions
+#define QUANTIZE_VERTICES 1
+
+// 1: the ray payload is packed (shared exponent colors, octahedral direction and normal, flag bits), see
+// shaders/payload.h.glsl for the layout and its size. 0: PassableInfo as is, for comparing the two with the benchmark
+#define PACK_PAYLOAD 1
+
+// 1: the per pixel sums of the accumulation image are Kahan compensated, with the compensation in a second rgba32f image,
+// so long renders don't lose small samples to rounding. 0: plain sums, which halves the accumulation bandwidth
+#define COMPENSATED_ACCUMULATION 1
+#define RESOLVE_WORKGROUP_SIZE 8
+
 struct PushConstantsStruct {
     mat4 invView;
     mat4 invProjection;
+    mat4 previousViewProjection;  // of the image in the history, for temporal reprojection
     uint sampleBatch;
+    uint seed;  // mixed into the RNG state. fixed by the benchmark so that runs are reproducible
+    uint samplesPerPixel;     // traced by this dispatch
+    uint accumulatedSamples;  // per pixel, already in the image
+    uint firstRow;            // of the band of rows this dispatch traces. the dispatch is only as high as the band
+    uint bounces;             // per sample, at most BOUNCES_PER_SAMPLE. fewer for the motion preview
+    uint previewScale;        // each launched pixel covers a block this wide and high. 1 traces at full resolution
+    uint reproject;           // 1: pixels without samples start from the history instead of from scratch
+};
+
+// Temporal reprojection (src/graphics/TemporalHistory.h): a history sample is reused if its surface point is within
+// REPROJECTION_TOLERANCE times the view depth of the pixel's new one. Reused pixels keep at most
+// REPROJECTION_MAX_SAMPLES, so shading that changed with the view (reflections, refractions) fades out quickly
+#define REPROJECTION_TOLERANCE 0.01
+#define REPROJECTION_MAX_SAMPLES 64
+
+// Denoiser (src/graphics/Denoiser.h): how strongly the edge-stopping functions of the a-trous filter separate pixels.
+// Depth is compared as the distance to the center pixel's tangent plane, relative to its view depth. Pixels with fewer
+// than DENOISE_MIN_HISTORY samples estimate their variance from their neighbours
+#define DENOISE_SIGMA_LUMINANCE 4.0
+#define DENOISE_SIGMA_NORMAL 128.0
+#define DENOISE_SIGMA_DEPTH 0.02
+#define DENOISE_SIGMA_ALBEDO 0.1
+#define DENOISE_MIN_HISTORY 4
+#define DENOISE_WORKGROUP_SIZE 8
+
+struct DenoisePushConstantsStruct {
+    uint stepSize;    // between the taps of this iteration, in pixels
+    uint source;      // 0 or 1: the filter image this iteration reads. it writes the other one
+    uint finalPass;   // 1: write the output image instead
+};
+
+// First hit AOVs (src/graphics/AovImages.h): bits of the raygen shader's enabledAovs specialization constant
+#define AOV_ALBEDO (1u << 0)
+#define AOV_NORMAL (1u << 1)
+#define AOV_DEPTH (1u << 2)
+#define AOV_ID (1u << 3)
+#define AOV_COST (1u << 4)
+#define AOV_COUNT 5
+
+// Tonemapping (src/graphics/ToneMapper.h): auto exposure from a histogram of the displayed pixels' log2 luminance between
+// TONEMAP_MIN_LOG_LUMINANCE and TONEMAP_MAX_LOG_LUMINANCE. The first bin holds the black pixels, which don't count.
+// The exposure maps the geometric mean luminance to TONEMAP_KEY and follows changes by TONEMAP_ADAPTATION_RATE per
+// second, exponentially
+#define TONEMAP_WORKGROUP_SIZE 16
+#define TONEMAP_HISTOGRAM_BINS (TONEMAP_WORKGROUP_SIZE * TONEMAP_WORKGROUP_SIZE)
+#define TONEMAP_MIN_LOG_LUMINANCE -10.0
+#define TONEMAP_MAX_LOG_LUMINANCE 6.0
+#define TONEMAP_KEY 0.18
+#define TONEMAP_ADAPTATION_RATE 2.0
+
+struct ToneMapPushConstantsStruct {
+    float deltaTime;  // since the previous frame, in seconds
+};
+
+// Adaptive sampling (src/graphics/AdaptiveSampler.h): pixels are traced until the relative standard error of their mean
+// luminance is below the threshold, but at least ADAPTIVE_MIN_SAMPLES times
+#define ADAPTIVE_MIN_SAMPLES 16
+#define ADAPTIVE_MIN_LUMINANCE 0.01
+
+struct AdaptivePushConstantsStruct {
+    float threshold;
+};
+
+// lambertian, metal, dielectric: the triangle hit groups, the sphere hit groups and the wavefront shading kernels
+#define MATERIAL_COUNT 3
+
+// Wavefront integrator (src/graphics/WavefrontIntegrator.h). Each queue is a list of path indices with a counter that
+// doubles as the indirect dispatch arguments: two ray queues, read and written alternately by the bounces, then one
+// queue per material
+#define WAVEFRONT_WORKGROUP_SIZE 64
+#define WAVEFRONT_QUEUE_COUNT (2 + MATERIAL_COUNT)
+
+struct WavefrontPushConstantsStruct {
+    PushConstantsStruct frame;
+    uint sampleIndex;  // within the batch of SAMPLES_PER_PIXEL
+    uint rayQueue;     // 0 or 1: the ray queue traced by this bounce. continuing paths go to the other one
+};
+
+// one path per pixel, in scalar layout
+struct WavefrontPath {
+    vec3 origin;
+    vec3 direction;
+    vec3 throughput;
+    vec3 radiance;
+    uint rngState;
+};
+
+struct WavefrontHit {
+    vec3 worldPosition;
+    vec3 worldNormal;
+    vec3 geometricNormal;
+    uint objectID;
+    uint frontFace;
+};
+
+struct WavefrontQueueCounter {
+    uint groupCountX;  // VkDispatchIndirectCommand, for WAVEFRONT_WORKGROUP_SIZE threads per group
+    uint groupCountY;
+    uint groupCountZ;
+    uint count;
 };
 
 #endif // #ifndef RAYGUN_VK_POLYGLOT_COMMON_H
\ No newline at end of file
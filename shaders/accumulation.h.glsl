@@ -0,0 +1,64 @@
+#ifndef REINA_ACCUMULATION_H
+#define REINA_ACCUMULATION_H
+
+// The accumulation image (src/graphics/Accumulator.h): each pixel's sum of samples and their count, written by the
+// raygen shader and the wavefront integrator. The resolve pass and the denoiser turn it into the display image.
+// Summing instead of blending a running mean keeps every batch's rounding error from compounding into the mean, and
+// with COMPENSATED_ACCUMULATION the low order bits each addition rounds off are carried over to the next one.
+
+#include "../polyglot/common.h"
+
+// rgb: sum of the pixel's samples, a: their count
+layout(binding = 0, set = 0, rgba32f) uniform image2D storageImage;
+
+#if COMPENSATED_ACCUMULATION
+// rgb: what the last addition to the sum rounded off, negated
+layout(binding = 20, set = 0, rgba32f) uniform image2D compensationImage;
+#endif
+
+struct Accumulation {
+    vec3 sum;
+    vec3 compensation;
+    float samples;
+};
+
+Accumulation loadAccumulation(ivec2 pixel) {
+    const vec4 sum = imageLoad(storageImage, pixel);
+#if COMPENSATED_ACCUMULATION
+    return Accumulation(sum.rgb, imageLoad(compensationImage, pixel).rgb, sum.a);
+#else
+    return Accumulation(sum.rgb, vec3(0.0), sum.a);
+#endif
+}
+
+void storeAccumulation(ivec2 pixel, Accumulation accumulation) {
+    imageStore(storageImage, pixel, vec4(accumulation.sum, accumulation.samples));
+#if COMPENSATED_ACCUMULATION
+    imageStore(compensationImage, pixel, vec4(accumulation.compensation, 0.0));
+#endif
+}
+
+// a pixel that starts from a mean of earlier samples, e.g. reprojected ones
+Accumulation startAccumulation(vec3 mean, uint samples) {
+    return Accumulation(mean * float(samples), vec3(0.0), float(samples));
+}
+
+Accumulation addSamples(Accumulation accumulation, vec3 batchSum, uint batchSamples) {
+#if COMPENSATED_ACCUMULATION
+    // Kahan summation. precise keeps the compiler from simplifying the compensation to 0
+    precise vec3 corrected = batchSum - accumulation.compensation;
+    precise vec3 sum = accumulation.sum + corrected;
+    accumulation.compensation = (sum - accumulation.sum) - corrected;
+    accumulation.sum = sum;
+#else
+    accumulation.sum += batchSum;
+#endif
+    accumulation.samples += float(batchSamples);
+    return accumulation;
+}
+
+vec3 getMean(Accumulation accumulation) {
+    return (accumulation.sum - accumulation.compensation) / max(accumulation.samples, 1.0);
+}
+
+#endif  // #ifndef REINA_ACCUMULATION_H
@@ -0,0 +1,21 @@
+#ifndef REINA_ADAPTIVE_H
+#define REINA_ADAPTIVE_H
+
+// Per pixel statistics and the work list of adaptive sampling (src/graphics/AdaptiveSampler.h). Only bound when
+// --adaptive is set, after the scene bindings of set 0.
+
+#extension GL_EXT_scalar_block_layout : require
+
+#include "shaderCommon.h.glsl"
+
+// x: mean luminance, y: mean squared luminance, w: sample count. of the samples that weren't NaN
+layout(binding = 7, set = 0, rgba32f) uniform image2D momentsImage;
+
+layout(binding = 8, set = 0, scalar) buffer WorkList {
+    uint traceWidth;  // VkTraceRaysIndirectCommandKHR, one invocation per listed pixel
+    uint traceHeight;
+    uint traceDepth;
+    uint workListPixels[];  // y * width + x
+};
+
+#endif  // #ifndef REINA_ADAPTIVE_H
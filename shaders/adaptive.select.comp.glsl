@@ -0,0 +1,39 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "adaptive.h.glsl"
+#include "../polyglot/common.h"
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(push_constant) uniform PushConsts {
+    AdaptivePushConstantsStruct pushConstants;
+};
+
+// Lists the pixels whose mean luminance still has a relative standard error above the threshold, as the work list of
+// the next trace rays dispatch. Pixels with too few samples for a variance estimate are always listed.
+void main() {
+    const ivec2 resolution = imageSize(momentsImage);
+    const ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+    if (pixel.x >= resolution.x || pixel.y >= resolution.y) {
+        return;
+    }
+
+    const vec4 moments = imageLoad(momentsImage, pixel);
+    const float samples = moments.w;
+
+    bool noisy = samples < float(ADAPTIVE_MIN_SAMPLES);
+    if (!noisy) {
+        // unbiased sample variance, then the variance of the mean
+        const float variance = max(moments.y - moments.x * moments.x, 0.0) * samples / (samples - 1.0);
+        const float standardError = sqrt(variance / samples);
+
+        // dark pixels would never converge relative to their own tiny mean
+        noisy = standardError > pushConstants.threshold * max(moments.x, ADAPTIVE_MIN_LUMINANCE);
+    }
+
+    if (noisy) {
+        const uint slot = atomicAdd(traceWidth, 1);
+        workListPixels[slot] = uint(pixel.y * resolution.x + pixel.x);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef REINA_AOV_H
+#define REINA_AOV_H
+
+// First hit AOVs (src/graphics/AovImages.h), written by the raygen shader after the bindings of the other features.
+// Which ones are written is the enabledAovs specialization constant, so the pipeline of a disabled AOV has neither its
+// store nor the work that only feeds it. Alpha is 1 where the camera ray hit a surface and 0 for the sky, so the images
+// double as a coverage mask. The denoiser filters with the albedo and normal, see shaders/denoise.h.glsl. Needs tlas and
+// GL_EXT_ray_query in the including shader.
+
+#include "objectProperties.h.glsl"
+#include "../polyglot/common.h"
+
+layout(constant_id = 0) const uint enabledAovs = 0;
+
+layout(binding = 15, set = 0, rgba32f) uniform image2D aovAlbedoImage;  // rgb: reflectivity
+layout(binding = 16, set = 0, rgba32f) uniform image2D aovNormalImage;  // xyz: world space shading normal
+layout(binding = 17, set = 0, rgba32f) uniform image2D aovDepthImage;   // r: distance along the view direction, 0 for the sky
+
+// x: object (the instance's custom index), y: primitive, z: instance. -1 for the sky
+layout(binding = 18, set = 0, rgba32f) uniform image2D aovIdImage;
+
+// r: segments traced per sample, averaged over the pixel's first dispatch
+layout(binding = 19, set = 0, rgba32f) uniform image2D aovCostImage;
+
+struct Aovs {
+    vec3 albedo;
+    vec3 normal;
+    float depth;
+    vec3 ids;
+    float segments;
+    bool hit;
+};
+
+bool isAovEnabled(uint aov) {
+    return (enabledAovs & aov) != 0;
+}
+
+// the payload has no room for the hit's IDs, so the camera ray is traced again with a ray query, like
+// wavefront.intersect.comp.glsl. only when the ID AOV is enabled
+vec3 traceAovIds(vec3 origin, vec3 direction) {
+    rayQueryEXT rayQuery;
+    rayQueryInitializeEXT(rayQuery, tlas, gl_RayFlagsOpaqueEXT, 0xFF, origin, 0.0, direction, 10000.0);
+
+    while (rayQueryProceedEXT(rayQuery)) {
+        if (rayQueryGetIntersectionTypeEXT(rayQuery, false) != gl_RayQueryCandidateIntersectionAABBEXT) {
+            continue;
+        }
+
+        const vec4 sphere = getSphere(rayQueryGetIntersectionInstanceCustomIndexEXT(rayQuery, false), rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, false));
+        const float tMax = rayQueryGetIntersectionTypeEXT(rayQuery, true) == gl_RayQueryCommittedIntersectionNoneEXT
+                ? 10000.0
+                : rayQueryGetIntersectionTEXT(rayQuery, true);
+
+        float t;
+        if (intersectSphere(sphere, rayQueryGetIntersectionObjectRayOriginEXT(rayQuery, false), rayQueryGetIntersectionObjectRayDirectionEXT(rayQuery, false), rayQueryGetRayTMinEXT(rayQuery), tMax, t)) {
+            rayQueryGenerateIntersectionEXT(rayQuery, t);
+        }
+    }
+
+    if (rayQueryGetIntersectionTypeEXT(rayQuery, true) == gl_RayQueryCommittedIntersectionNoneEXT) {
+        return vec3(-1);
+    }
+
+    return vec3(
+        rayQueryGetIntersectionInstanceCustomIndexEXT(rayQuery, true),
+        rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, true),
+        rayQueryGetIntersectionInstanceIdEXT(rayQuery, true)
+    );
+}
+
+void storeAovs(ivec2 pixel, Aovs aovs) {
+    const float coverage = aovs.hit ? 1.0 : 0.0;
+
+    if (isAovEnabled(AOV_ALBEDO)) {
+        imageStore(aovAlbedoImage, pixel, vec4(aovs.albedo, coverage));
+    }
+    if (isAovEnabled(AOV_NORMAL)) {
+        imageStore(aovNormalImage, pixel, vec4(aovs.normal, coverage));
+    }
+    if (isAovEnabled(AOV_DEPTH)) {
+        imageStore(aovDepthImage, pixel, vec4(vec3(aovs.depth), coverage));
+    }
+    if (isAovEnabled(AOV_ID)) {
+        imageStore(aovIdImage, pixel, vec4(aovs.ids, coverage));
+    }
+    if (isAovEnabled(AOV_COST)) {
+        imageStore(aovCostImage, pixel, vec4(vec3(aovs.segments), coverage));
+    }
+}
+
+#endif  // #ifndef REINA_AOV_H
@@ -0,0 +1,61 @@
+#ifndef REINA_CAMERA_H
+#define REINA_CAMERA_H
+
+// Primary rays, shared by the raygen shader and the wavefront integrator's generation kernel.
+
+#include "shaderCommon.h.glsl"
+
+struct Ray {
+    vec3 origin;
+    vec3 direction;
+};
+
+// Uses the Box-Muller transform to return a normally distributed (centered
+// at 0, standard deviation 1) 2D point.
+vec2 randomGaussian(inout uint rngState) {
+    // Almost uniform in (0, 1] - make sure the value is never 0:
+    const float u1 = max(1e-5, stepAndOutputRNGFloat(rngState));
+    const float u2 = stepAndOutputRNGFloat(rngState);  // In [0, 1]
+    const float r = sqrt(-2.0 * log(u1));
+    const float theta = 2 * k_pi * u2;  // Random in [0, 2pi]
+    return r * vec2(cos(theta), sin(theta));
+}
+
+Ray getStartingRay(
+    vec2 pixel,
+    vec2 resolution,
+    mat4 invView,
+    mat4 invProjection,
+    inout uint rngState
+) {
+    // Random pixel center for antialiasing
+    vec2 randomPixelCenter = pixel + vec2(0.5) + 0.375 * randomGaussian(rngState);
+
+    vec2 ndc = vec2(
+        (randomPixelCenter.x / resolution.x) * 2.0 - 1.0,
+        -((randomPixelCenter.y / resolution.y) * 2.0 - 1.0)  // Flip y-coordinate so image isn't upside down
+    );
+
+    vec4 clipPos = vec4(ndc, -1.0, 1.0);
+
+    // Unproject from clip space to view (camera) space using the inverse projection matrix.
+    vec4 viewPos = vec4(invProjection * clipPos);
+    viewPos /= viewPos.w;  // Perspective divide
+
+    // Ray direction in view space (camera space origin is at (0,0,0)).
+    vec3 viewDir = normalize(viewPos.xyz);
+
+    // Transform the view-space direction to world space using the inverse view matrix.
+    // Use a w component of 0.0 to indicate that we're transforming a direction.
+    vec4 worldDir4 = vec4(invView * vec4(viewDir, 0.0));
+    vec3 rayDirection = normalize(worldDir4.xyz);
+
+    return Ray(invView[3].xyz, rayDirection);
+}
+
+// the RNG state of a pixel at the start of a sample batch
+uint getInitialRngState(ivec2 pixel, ivec2 resolution, uint sampleBatch, uint seed) {
+    return uint((sampleBatch * resolution.y + pixel.y) * resolution.x + pixel.x) ^ (seed * 0x9E3779B9u);
+}
+
+#endif  // #ifndef REINA_CAMERA_H
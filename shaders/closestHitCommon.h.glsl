@@ -4,144 +4,27 @@
 #extension GL_EXT_ray_tracing : require
 #extension GL_EXT_scalar_block_layout : require
 #include "shaderCommon.h.glsl"
+#include "hitInfo.h.glsl"
+#include "materials.h.glsl"
+#include "payload.h.glsl"
 
 hitAttributeEXT vec2 attributes;
 
-layout(binding = 2, set = 0, scalar) buffer Vertices {
-    vec4 vertices[];
-};
-
-layout(binding = 3, set = 0, scalar) buffer Indices {
-    uint indices[];
-};
-
-layout(location = 0) rayPayloadInEXT PassableInfo pld;
-
-struct ObjectProperties {
-    uint indicesBytesOffset;
-    vec3 albedo;
-    vec4 emission;
-    float fuzzOrRefIdx;
-    vec3 padding2;
-};
-
-layout(binding = 4, set = 0, scalar) buffer ObjectPropertiesBuffer {
-    ObjectProperties objectProperties[];
-};
-
-struct HitInfo {
-    vec3 objectPosition;
-    vec3 worldPosition;
-    vec3 worldNormal;
-    vec3 color;
-    bool frontFace;
-};
+layout(location = 0) rayPayloadInEXT Payload pld;
 
+#ifdef SPHERE_PRIMITIVE
+// compiled into the closest hit shaders of the procedural hit groups, see sphere.rint.glsl
 HitInfo getObjectHitInfo() {
-    HitInfo result;
-    // Get the ID of the triangle
-    const uint primitiveID = gl_PrimitiveID;
-
-    // divide by 4 since 4 bytes for an int32
-    const uint indexOffset = objectProperties[gl_InstanceCustomIndexEXT].indicesBytesOffset / 4;
-
-    // Get the indices of the vertices of the triangle
-    const uint i0 = indices[3 * primitiveID + indexOffset + 0];
-    const uint i1 = indices[3 * primitiveID + indexOffset + 1];
-    const uint i2 = indices[3 * primitiveID + indexOffset + 2];
-
-    // Get the vertices of the triangle
-    const vec3 v0 = vertices[i0].xyz;
-    const vec3 v1 = vertices[i1].xyz;
-    const vec3 v2 = vertices[i2].xyz;
-
-    // Get the barycentric coordinates of the intersection
-    vec3 barycentrics = vec3(0.0, attributes.x, attributes.y);
-    barycentrics.x    = 1.0 - barycentrics.y - barycentrics.z;
-
-    // Compute the coordinates of the intersection
-    result.objectPosition = v0 * barycentrics.x + v1 * barycentrics.y + v2 * barycentrics.z;
-    // Transform from object space to world space:
-    result.worldPosition = gl_ObjectToWorldEXT * vec4(result.objectPosition, 1.0f);
-
-    const vec3 objectNormal = cross(v1 - v0, v2 - v0);
-    // Transform normals from object space to world space. These use the transpose of the inverse matrix,
-    // because they're directions of normals, not positions:
-    result.worldNormal = normalize((objectNormal * gl_WorldToObjectEXT).xyz);
-
-    // Flip the normal so it points against the ray direction:
-    const vec3 rayDirection = gl_WorldRayDirectionEXT;
-
-    result.frontFace = dot(rayDirection, result.worldNormal) < 0;
-    result.worldNormal = faceforward(result.worldNormal, rayDirection, result.worldNormal);
-
-    return result;
-}
-
-/*
- * Credit: Carsten Wächter and Nikolaus Binder from "A Fast and Robust Method for Avoiding Self-Intersection"
- * from Ray Tracing Gems (version 1.7, 2020)
- *
- * You can negate the normal to pass through the surface
- */
-vec3 offsetPositionAlongNormal(vec3 worldPosition, vec3 normal) {
-    // Convert the normal to an integer offset.
-    const float int_scale = 256.0f;
-    const ivec3 of_i = ivec3(int_scale * normal);
-
-    // Offset each component of worldPosition using its binary representation.
-    // Handle the sign bits correctly.
-    const vec3 p_i = vec3(
-        intBitsToFloat(floatBitsToInt(worldPosition.x) + ((worldPosition.x < 0) ? -of_i.x : of_i.x)),
-        intBitsToFloat(floatBitsToInt(worldPosition.y) + ((worldPosition.y < 0) ? -of_i.y : of_i.y)),
-        intBitsToFloat(floatBitsToInt(worldPosition.z) + ((worldPosition.z < 0) ? -of_i.z : of_i.z))
+    return getSphereHitInfo(
+            gl_InstanceCustomIndexEXT, gl_PrimitiveID, gl_HitTEXT,
+            gl_ObjectRayOriginEXT, gl_ObjectRayDirectionEXT, gl_WorldRayOriginEXT, gl_WorldRayDirectionEXT,
+            gl_WorldToObjectEXT
     );
-
-    // Use a floating-point offset instead for points near (0,0,0), the origin.
-    const float origin = 1.0f / 32.0f;
-    const float floatScale = 1.0f / 65536.0f;
-    return vec3(
-        abs(worldPosition.x) < origin ? worldPosition.x + floatScale * normal.x : p_i.x,
-        abs(worldPosition.y) < origin ? worldPosition.y + floatScale * normal.y : p_i.y,
-        abs(worldPosition.z) < origin ? worldPosition.z + floatScale * normal.z : p_i.z
-    );
-}
-
-/*
- * Keep the ray moving in the same direction and origin and enable the 'skip' flag, which tells the raygen shader to
- * not count this ray to the total color. This is useful for skipping rays that hit the back face of an object.
- * I can't just turn on back face culling because some materials (like dielectrics) require the back face to be
- * considered.
- */
-void skip(HitInfo hitInfo) {
-    // ignore back faces. this should ideally be done in the any hit shader but I don't feel like modifying the SBT
-    // right now.
-    // todo: do this in the any hit shader instead
-    pld.rayOrigin = offsetPositionAlongNormal(hitInfo.worldPosition, -hitInfo.worldNormal);
-    pld.rayDirection = gl_WorldRayDirectionEXT;
-    pld.rayHitSky = false;
-    pld.skip = true;
 }
-
-vec3 randomUnitVec(inout uint rngState) {
-    // todo: see if this method or sampling a sphere is faster. profile it
-    while (true) {
-        vec3 vector = vec3(stepAndOutputRNGFloat(rngState), stepAndOutputRNGFloat(rngState), stepAndOutputRNGFloat(rngState));
-
-        float lenSquared = dot(vector, vector);
-        if (0.0001 < lenSquared && lenSquared < 1) {
-            return normalize(vector);
-        }
-    }
-}
-
-vec3 diffuseReflection(vec3 normal, inout uint rngState) {
-    const float theta = 2.0 * k_pi * stepAndOutputRNGFloat(rngState);  // Random in [0, 2pi]
-    const float u = 2.0 * stepAndOutputRNGFloat(rngState) - 1.0;   // Random in [-1, 1]
-    const float r = sqrt(1.0 - u * u);
-    const vec3 direction = normal + vec3(r * cos(theta), r * sin(theta), u);
-
-    return normalize(direction);
+#else
+HitInfo getObjectHitInfo() {
+    return getTriangleHitInfo(gl_InstanceCustomIndexEXT, gl_PrimitiveID, attributes, gl_ObjectToWorldEXT, gl_WorldToObjectEXT, gl_WorldRayDirectionEXT);
 }
+#endif
 
-#endif  // #ifndef VK_MINI_PATH_TRACER_CLOSEST_HIT_COMMON_H
\ No newline at end of file
+#endif  // #ifndef VK_MINI_PATH_TRACER_CLOSEST_HIT_COMMON_H
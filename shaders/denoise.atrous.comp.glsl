@@ -0,0 +1,87 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "denoise.h.glsl"
+
+layout(push_constant) uniform PushConsts {
+    DenoisePushConstantsStruct pushConstants;
+};
+
+vec4 loadFiltered(ivec2 pixel) {
+    return pushConstants.source == 0 ? imageLoad(filterImage0, pixel) : imageLoad(filterImage1, pixel);
+}
+
+// the variance blurred with a 3x3 gaussian, which keeps single noisy variances from stopping the filter
+float filteredVariance(ivec2 pixel, ivec2 resolution) {
+    const float gaussian[2] = float[2](0.25, 0.125);
+
+    float variance = 0.0;
+    float summedWeights = 0.0;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            const ivec2 neighbour = pixel + ivec2(x, y);
+            if (any(lessThan(neighbour, ivec2(0))) || any(greaterThanEqual(neighbour, resolution))) {
+                continue;
+            }
+
+            const float weight = gaussian[abs(x)] * gaussian[abs(y)];
+            variance += weight * loadFiltered(neighbour).a;
+            summedWeights += weight;
+        }
+    }
+
+    return variance / summedWeights;
+}
+
+// One iteration of the edge-avoiding a-trous wavelet filter (Dammertz et al., as used by SVGF): a 5x5 B3 spline kernel
+// whose taps are stepSize pixels apart, weighted by how alike the pixels' surfaces and luminances are. The variance is
+// filtered along with the color, so each iteration trusts the luminance a little more.
+void main() {
+    const ivec2 resolution = imageSize(storageImage);
+    const ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, resolution))) {
+        return;
+    }
+
+    const vec4 center = loadFiltered(pixel);
+    const Surface centerSurface = loadSurface(pixel);
+
+    vec4 filtered = center;
+    if (centerSurface.position.w > 0) {
+        const float spline[3] = float[3](3.0 / 8.0, 1.0 / 4.0, 1.0 / 16.0);
+        const float centerLuminance = luminance(center.rgb);
+        const float luminanceScale = DENOISE_SIGMA_LUMINANCE * sqrt(filteredVariance(pixel, resolution)) + 1e-10;
+
+        vec3 summedColor = vec3(0.0);
+        float summedVariance = 0.0;
+        float summedWeights = 0.0;
+
+        for (int y = -2; y <= 2; y++) {
+            for (int x = -2; x <= 2; x++) {
+                const ivec2 neighbour = pixel + ivec2(x, y) * int(pushConstants.stepSize);
+                if (any(lessThan(neighbour, ivec2(0))) || any(greaterThanEqual(neighbour, resolution))) {
+                    continue;
+                }
+
+                const vec4 sampled = loadFiltered(neighbour);
+                const float luminanceWeight = exp(-abs(luminance(sampled.rgb) - centerLuminance) / luminanceScale);
+                const float weight = spline[abs(x)] * spline[abs(y)] * luminanceWeight
+                        * surfaceWeight(centerSurface, loadSurface(neighbour));
+
+                summedColor += weight * sampled.rgb;
+                summedVariance += weight * weight * sampled.a;
+                summedWeights += weight;
+            }
+        }
+
+        // the center's own weight is spline[0]², so the sum isn't 0
+        filtered = vec4(summedColor / summedWeights, summedVariance / (summedWeights * summedWeights));
+    }
+
+    if (pushConstants.finalPass != 0) {
+        imageStore(outputImage, pixel, vec4(filtered.rgb, 1.0));
+    } else if (pushConstants.source == 0) {
+        imageStore(filterImage1, pixel, filtered);
+    } else {
+        imageStore(filterImage0, pixel, filtered);
+    }
+}
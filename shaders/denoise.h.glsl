@@ -0,0 +1,49 @@
+#ifndef REINA_DENOISE_H
+#define REINA_DENOISE_H
+
+// Shared by the passes of the denoiser (src/graphics/Denoiser.h). Set 0 is the scene's, with the positions and moments
+// of shaders/reprojection.h.glsl and the albedo and normal AOVs of shaders/aov.h.glsl, set 1 the denoiser's own images.
+
+#include "shaderCommon.h.glsl"
+#include "../polyglot/common.h"
+#include "reprojection.h.glsl"
+#include "accumulation.h.glsl"
+
+layout(local_size_x = DENOISE_WORKGROUP_SIZE, local_size_y = DENOISE_WORKGROUP_SIZE) in;
+
+// declared here rather than through aov.h.glsl, which needs the TLAS. a: 1 for a surface, 0 for the sky
+layout(binding = 15, set = 0, rgba32f) uniform readonly image2D aovAlbedoImage;
+layout(binding = 16, set = 0, rgba32f) uniform readonly image2D aovNormalImage;
+
+// rgb: color, a: variance of its luminance. written by the variance pass, then read and written alternately
+layout(binding = 0, set = 1, rgba32f) uniform image2D filterImage0;
+layout(binding = 1, set = 1, rgba32f) uniform image2D filterImage1;
+layout(binding = 2, set = 1, rgba16f) uniform writeonly image2D outputImage;  // the display image, see Accumulator
+
+struct Surface {
+    vec4 position;  // w: view depth, 0 for the sky
+    vec3 normal;
+    vec3 albedo;
+};
+
+Surface loadSurface(ivec2 pixel) {
+    // an albedo of 1 keeps sky pixels apart from black surfaces
+    const vec4 albedo = imageLoad(aovAlbedoImage, pixel);
+    return Surface(imageLoad(positionImage, pixel), imageLoad(aovNormalImage, pixel).xyz, albedo.a > 0.0 ? albedo.rgb : vec3(1));
+}
+
+// 1 if the pixels show the same surface, falling off with the differences of their depth, normal and albedo
+float surfaceWeight(Surface center, Surface other) {
+    if (other.position.w == 0) {
+        return 0.0;
+    }
+
+    const float planeDistance = abs(dot(center.normal, other.position.xyz - center.position.xyz));
+    const float depthWeight = exp(-planeDistance / (DENOISE_SIGMA_DEPTH * center.position.w));
+    const float normalWeight = pow(max(dot(center.normal, other.normal), 0.0), DENOISE_SIGMA_NORMAL);
+    const float albedoWeight = exp(-distance(center.albedo, other.albedo) / DENOISE_SIGMA_ALBEDO);
+
+    return depthWeight * normalWeight * albedoWeight;
+}
+
+#endif  // #ifndef REINA_DENOISE_H
@@ -0,0 +1,43 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "denoise.h.glsl"
+
+// Estimates the variance of each pixel's mean luminance from the moments of its samples, which reprojection carries
+// over camera moves. Pixels with a short history, e.g. just disoccluded ones, use the moments of their neighbours on
+// the same surface instead, as their own are too noisy.
+void main() {
+    const ivec2 resolution = imageSize(storageImage);
+    const ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, resolution))) {
+        return;
+    }
+
+    const Accumulation accumulation = loadAccumulation(pixel);
+    const uint samples = uint(accumulation.samples);
+    const Surface center = loadSurface(pixel);
+
+    vec2 moments = imageLoad(luminanceMomentsImage, pixel).xy;
+    if (samples < DENOISE_MIN_HISTORY && center.position.w > 0) {
+        vec2 summedMoments = vec2(0.0);
+        float summedWeights = 0.0;
+
+        for (int y = -3; y <= 3; y++) {
+            for (int x = -3; x <= 3; x++) {
+                const ivec2 neighbour = pixel + ivec2(x, y);
+                if (any(lessThan(neighbour, ivec2(0))) || any(greaterThanEqual(neighbour, resolution))) {
+                    continue;
+                }
+
+                const float weight = surfaceWeight(center, loadSurface(neighbour));
+                summedMoments += weight * imageLoad(luminanceMomentsImage, neighbour).xy;
+                summedWeights += weight;
+            }
+        }
+
+        // the center always counts fully, so the sum isn't 0
+        moments = summedMoments / summedWeights;
+    }
+
+    const float sampleVariance = max(moments.y - moments.x * moments.x, 0.0);
+    imageStore(filterImage0, pixel, vec4(getMean(accumulation), sampleVariance / float(max(samples, 1u))));
+}
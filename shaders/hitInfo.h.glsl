@@ -0,0 +1,177 @@
+#ifndef REINA_HIT_INFO_H
+#define REINA_HIT_INFO_H
+
+// Surface information at a hit, from the scene buffers. Shared by the closest hit shaders, which pass in the ray
+// tracing built-ins, and the wavefront intersection kernel, which passes in the ray query's committed intersection.
+
+#extension GL_EXT_scalar_block_layout : require
+#include "shaderCommon.h.glsl"
+#include "vertexCompression.h.glsl"
+#include "objectProperties.h.glsl"
+#include "../polyglot/common.h"
+
+#if QUANTIZE_VERTICES
+// positions in the mesh's quantized space, which the instance transform maps to world space like the BLAS
+layout(binding = 2, set = 0, scalar) buffer Vertices {
+    uvec2 vertices[];
+};
+
+vec3 getVertexPosition(uint index) {
+    return unpackQuantizedPosition(vertices[index]);
+}
+#else
+layout(binding = 2, set = 0, scalar) buffer Vertices {
+    vec4 vertices[];
+};
+
+vec3 getVertexPosition(uint index) {
+    return vertices[index].xyz;
+}
+#endif
+
+// model-local indices, 16 or 32 bits depending on the object (see ObjectProperties.shortIndices)
+layout(binding = 3, set = 0, scalar) buffer Indices {
+    uint indices[];
+};
+
+// per vertex: x is the octahedral normal, y the UV as two half floats
+layout(binding = 5, set = 0, scalar) buffer Attributes {
+    uvec2 attributes[];
+} vertexAttributes;
+
+struct HitInfo {
+    vec3 objectPosition;
+    vec3 worldPosition;
+    vec3 worldNormal;      // shading normal, interpolated if the mesh has vertex normals
+    vec3 geometricNormal;  // of the triangle. use this to offset ray origins
+    vec2 uv;
+    vec3 color;
+    bool frontFace;
+};
+
+uvec3 getTriangleIndices(uint objectID, uint primitiveID) {
+    const ObjectProperties properties = objectProperties[objectID];
+    uvec3 result;
+
+    if (properties.shortIndices != 0) {
+        // two per uint, the first one in the low half
+        const uint first = properties.indicesBytesOffset / 2 + 3 * primitiveID;
+        for (uint i = 0; i < 3; i++) {
+            const uint element = first + i;
+            result[i] = bitfieldExtract(indices[element >> 1], int(element & 1) * 16, 16);
+        }
+    } else {
+        const uint first = properties.indicesBytesOffset / 4 + 3 * primitiveID;
+        result = uvec3(indices[first], indices[first + 1], indices[first + 2]);
+    }
+
+    return result + properties.firstVertex;
+}
+
+HitInfo getTriangleHitInfo(uint objectID, uint primitiveID, vec2 hitBarycentrics, mat4x3 objectToWorld, mat4x3 worldToObject, vec3 rayDirection) {
+    HitInfo result;
+
+    // Get the indices of the vertices of the triangle
+    const uvec3 triangle = getTriangleIndices(objectID, primitiveID);
+    const uint i0 = triangle.x;
+    const uint i1 = triangle.y;
+    const uint i2 = triangle.z;
+
+    // Get the vertices of the triangle
+    const vec3 v0 = getVertexPosition(i0);
+    const vec3 v1 = getVertexPosition(i1);
+    const vec3 v2 = getVertexPosition(i2);
+
+    // Get the barycentric coordinates of the intersection
+    vec3 barycentrics = vec3(0.0, hitBarycentrics.x, hitBarycentrics.y);
+    barycentrics.x    = 1.0 - barycentrics.y - barycentrics.z;
+
+    // Compute the coordinates of the intersection
+    result.objectPosition = v0 * barycentrics.x + v1 * barycentrics.y + v2 * barycentrics.z;
+    // Transform from object space to world space:
+    result.worldPosition = objectToWorld * vec4(result.objectPosition, 1.0f);
+
+    const vec3 objectNormal = cross(v1 - v0, v2 - v0);
+    // Transform normals from object space to world space. These use the transpose of the inverse matrix,
+    // because they're directions of normals, not positions:
+    result.geometricNormal = normalize((objectNormal * worldToObject).xyz);
+
+    // Flip the normal so it points against the ray direction:
+    result.frontFace = dot(rayDirection, result.geometricNormal) < 0;
+    result.geometricNormal = faceforward(result.geometricNormal, rayDirection, result.geometricNormal);
+
+    const uvec2 a0 = vertexAttributes.attributes[i0];
+    const uvec2 a1 = vertexAttributes.attributes[i1];
+    const uvec2 a2 = vertexAttributes.attributes[i2];
+
+    result.uv = unpackHalf2x16(a0.y) * barycentrics.x + unpackHalf2x16(a1.y) * barycentrics.y + unpackHalf2x16(a2.y) * barycentrics.z;
+
+    if (objectProperties[objectID].hasVertexNormals != 0) {
+        const vec3 shadingNormal = decodeOctahedral(a0.x) * barycentrics.x + decodeOctahedral(a1.x) * barycentrics.y + decodeOctahedral(a2.x) * barycentrics.z;
+        result.worldNormal = normalize((shadingNormal * worldToObject).xyz);
+
+        // keep the shading normal on the same side as the geometric one
+        if (dot(result.worldNormal, result.geometricNormal) < 0) {
+            result.worldNormal = -result.worldNormal;
+        }
+    } else {
+        result.worldNormal = result.geometricNormal;
+    }
+
+    return result;
+}
+
+// for the spheres of procedural objects, see sphere.rint.glsl
+HitInfo getSphereHitInfo(uint objectID, uint primitiveID, float t, vec3 objectRayOrigin, vec3 objectRayDirection, vec3 worldRayOrigin, vec3 worldRayDirection, mat4x3 worldToObject) {
+    HitInfo result;
+
+    const vec4 sphere = getSphere(objectID, primitiveID);
+
+    result.objectPosition = objectRayOrigin + objectRayDirection * t;
+    result.worldPosition = worldRayOrigin + worldRayDirection * t;
+
+    // analytic, so there's no separate shading normal
+    const vec3 objectNormal = (result.objectPosition - sphere.xyz) / sphere.w;
+    result.geometricNormal = normalize((objectNormal * worldToObject).xyz);
+
+    result.frontFace = dot(worldRayDirection, result.geometricNormal) < 0;
+    result.geometricNormal = faceforward(result.geometricNormal, worldRayDirection, result.geometricNormal);
+    result.worldNormal = result.geometricNormal;
+
+    // longitude and latitude
+    const vec3 unitNormal = normalize(objectNormal);
+    result.uv = vec2(atan(unitNormal.z, unitNormal.x) / (2.0 * k_pi) + 0.5, acos(clamp(unitNormal.y, -1.0, 1.0)) / k_pi);
+
+    return result;
+}
+
+/*
+ * Credit: Carsten Wächter and Nikolaus Binder from "A Fast and Robust Method for Avoiding Self-Intersection"
+ * from Ray Tracing Gems (version 1.7, 2020)
+ *
+ * You can negate the normal to pass through the surface
+ */
+vec3 offsetPositionAlongNormal(vec3 worldPosition, vec3 normal) {
+    // Convert the normal to an integer offset.
+    const float int_scale = 256.0f;
+    const ivec3 of_i = ivec3(int_scale * normal);
+
+    // Offset each component of worldPosition using its binary representation.
+    // Handle the sign bits correctly.
+    const vec3 p_i = vec3(
+        intBitsToFloat(floatBitsToInt(worldPosition.x) + ((worldPosition.x < 0) ? -of_i.x : of_i.x)),
+        intBitsToFloat(floatBitsToInt(worldPosition.y) + ((worldPosition.y < 0) ? -of_i.y : of_i.y)),
+        intBitsToFloat(floatBitsToInt(worldPosition.z) + ((worldPosition.z < 0) ? -of_i.z : of_i.z))
+    );
+
+    // Use a floating-point offset instead for points near (0,0,0), the origin.
+    const float origin = 1.0f / 32.0f;
+    const float floatScale = 1.0f / 65536.0f;
+    return vec3(
+        abs(worldPosition.x) < origin ? worldPosition.x + floatScale * normal.x : p_i.x,
+        abs(worldPosition.y) < origin ? worldPosition.y + floatScale * normal.y : p_i.y,
+        abs(worldPosition.z) < origin ? worldPosition.z + floatScale * normal.z : p_i.z
+    );
+}
+
+#endif  // #ifndef REINA_HIT_INFO_H
@@ -0,0 +1,152 @@
+#ifndef REINA_MATERIALS_H
+#define REINA_MATERIALS_H
+
+// How each material scatters a ray, written into a PassableInfo. Used by the per material closest hit shaders and the
+// per material shading kernels of the wavefront integrator. The values match reina::graphics::Material.
+
+#include "shaderCommon.h.glsl"
+#include "hitInfo.h.glsl"
+
+#define MATERIAL_LAMBERTIAN 0
+#define MATERIAL_METAL 1
+#define MATERIAL_DIELECTRIC 2
+
+/*
+ * Keep the ray moving in the same direction and origin and enable the 'skip' flag, which tells the raygen shader to
+ * not count this ray to the total color. This is useful for skipping rays that hit the back face of an object.
+ * I can't just turn on back face culling because some materials (like dielectrics) require the back face to be
+ * considered.
+ */
+void skip(HitInfo hitInfo, vec3 rayDirection, inout PassableInfo info) {
+    // ignore back faces. this should ideally be done in the any hit shader but I don't feel like modifying the SBT
+    // right now.
+    // todo: do this in the any hit shader instead
+    info.rayOrigin = offsetPositionAlongNormal(hitInfo.worldPosition, -hitInfo.geometricNormal);
+    info.rayDirection = rayDirection;
+    info.rayHitSky = false;
+    info.skip = true;
+    info.normal = hitInfo.worldNormal;
+}
+
+vec3 randomUnitVec(inout uint rngState) {
+    // todo: see if this method or sampling a sphere is faster. profile it
+    while (true) {
+        vec3 vector = vec3(stepAndOutputRNGFloat(rngState), stepAndOutputRNGFloat(rngState), stepAndOutputRNGFloat(rngState));
+
+        float lenSquared = dot(vector, vector);
+        if (0.0001 < lenSquared && lenSquared < 1) {
+            return normalize(vector);
+        }
+    }
+}
+
+vec3 diffuseReflection(vec3 normal, inout uint rngState) {
+    const float theta = 2.0 * k_pi * stepAndOutputRNGFloat(rngState);  // Random in [0, 2pi]
+    const float u = 2.0 * stepAndOutputRNGFloat(rngState) - 1.0;   // Random in [-1, 1]
+    const float r = sqrt(1.0 - u * u);
+    const vec3 direction = normal + vec3(r * cos(theta), r * sin(theta), u);
+
+    return normalize(direction);
+}
+
+void scatterLambertian(HitInfo hitInfo, uint objectID, vec3 rayDirection, inout PassableInfo info) {
+    // poor man's version of backface culling
+    if (!hitInfo.frontFace) {
+        skip(hitInfo, rayDirection, info);
+        return;
+    }
+
+    #ifdef DEBUG_SHOW_NORMALS
+        info.color = hitInfo.worldNormal * 0.5 + 0.5;
+    #else
+        info.color = objectProperties[objectID].albedo;
+    #endif
+
+    info.emission     = objectProperties[objectID].emission;
+    info.rayOrigin    = offsetPositionAlongNormal(hitInfo.worldPosition, hitInfo.geometricNormal);
+    info.rayDirection = diffuseReflection(hitInfo.worldNormal, info.rngState);
+    info.rayHitSky    = false;
+    info.skip         = false;
+    info.normal       = hitInfo.worldNormal;
+}
+
+void scatterMetal(HitInfo hitInfo, uint objectID, vec3 rayDirection, inout PassableInfo info) {
+    // poor man's version of backface culling
+    if (!hitInfo.frontFace) {
+        skip(hitInfo, rayDirection, info);
+        return;
+    }
+
+    info.color        = objectProperties[objectID].albedo;
+    info.emission     = objectProperties[objectID].emission;
+    info.rayOrigin    = offsetPositionAlongNormal(hitInfo.worldPosition, hitInfo.geometricNormal);
+    info.rayDirection = reflect(rayDirection, hitInfo.worldNormal) + objectProperties[objectID].fuzzOrRefIdx * randomUnitVec(info.rngState);
+    info.rayHitSky    = false;
+    info.skip         = false;
+    info.normal       = hitInfo.worldNormal;
+}
+
+float reflectance(float cosine, float ref_idx) {
+    // Use Schlick's approximation for reflectance
+    float r0 = (1 - ref_idx) / (1 + ref_idx);
+    r0 = r0 * r0;
+    return r0 + (1 - r0) * pow((1 - cosine), 5);
+}
+
+vec3 offsetPositionForDielectric(vec3 worldPosition, vec3 normal, vec3 rayDir) {
+    // If the ray is going inside (e.g. entering a dielectric), flip the normal.
+    vec3 offsetNormal = (dot(normal, rayDir) < 0.0) ? -normal : normal;
+
+    // Convert the normal to an integer offset.
+    const float int_scale = 256.0;
+    const ivec3 of_i = ivec3(int_scale * offsetNormal);
+
+    // Offset each component of worldPosition using its bit representation.
+    // The sign check on worldPosition components helps to handle negative values.
+    const vec3 p_i = vec3(
+        intBitsToFloat(floatBitsToInt(worldPosition.x) + ((worldPosition.x < 0.0) ? -of_i.x : of_i.x)),
+        intBitsToFloat(floatBitsToInt(worldPosition.y) + ((worldPosition.y < 0.0) ? -of_i.y : of_i.y)),
+        intBitsToFloat(floatBitsToInt(worldPosition.z) + ((worldPosition.z < 0.0) ? -of_i.z : of_i.z))
+    );
+
+    // For points near the origin, use a smaller floating-point offset.
+    const float origin = 1.0 / 32.0;
+    const float floatScale = 1.0 / 65536.0;
+    return vec3(
+        abs(worldPosition.x) < origin ? worldPosition.x + floatScale * offsetNormal.x : p_i.x,
+        abs(worldPosition.y) < origin ? worldPosition.y + floatScale * offsetNormal.y : p_i.y,
+        abs(worldPosition.z) < origin ? worldPosition.z + floatScale * offsetNormal.z : p_i.z
+    );
+}
+
+void scatterDielectric(HitInfo hitInfo, uint objectID, vec3 rayDirection, inout PassableInfo info) {
+    // todo: extract a bunch of this into a function
+    float ri = hitInfo.frontFace ? 1.0 / objectProperties[objectID].fuzzOrRefIdx : objectProperties[objectID].fuzzOrRefIdx;
+    vec3 unitDir = normalize(rayDirection);
+    float cosTheta = min(dot(-unitDir, hitInfo.worldNormal), 1.0);
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+
+    bool cannot_refract = bool(ri * sinTheta > 1.0);  // must wrap in bool() to prevent glsl linter from throwing false-positive error
+    float reflectivity = reflectance(cosTheta, ri);
+
+    if (cannot_refract || reflectivity > stepAndOutputRNGFloat(info.rngState)) {
+        // specular reflection
+        // add by k * randomUnitVec to make jagged shapes look slightly smoother
+        info.rayDirection = reflect(unitDir, hitInfo.worldNormal) + 0.02 * randomUnitVec(info.rngState);
+        info.color = vec3(1);
+        info.rayOrigin = offsetPositionAlongNormal(hitInfo.worldPosition, hitInfo.geometricNormal);
+    } else {
+        // refract
+        // add by k * randomUnitVec to make jagged shapes look slightly smoother
+        info.rayDirection = refract(unitDir, hitInfo.worldNormal, ri) + 0.02 * randomUnitVec(info.rngState);
+        info.color = objectProperties[objectID].albedo;
+        info.rayOrigin = offsetPositionForDielectric(hitInfo.worldPosition, hitInfo.geometricNormal, unitDir);
+    }
+
+    info.emission  = objectProperties[objectID].emission;
+    info.rayHitSky = false;
+    info.skip      = false;
+    info.normal    = hitInfo.worldNormal;
+}
+
+#endif  // #ifndef REINA_MATERIALS_H
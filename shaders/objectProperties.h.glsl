@@ -0,0 +1,51 @@
+#ifndef REINA_OBJECT_PROPERTIES_H
+#define REINA_OBJECT_PROPERTIES_H
+
+#extension GL_EXT_scalar_block_layout : require
+
+struct ObjectProperties {
+    uint indicesBytesOffset;
+    vec3 albedo;
+    vec4 emission;
+    float fuzzOrRefIdx;
+    uint hasVertexNormals;
+    uint firstVertex;  // the first sphere for sphere objects
+    uint shortIndices;
+};
+
+layout(binding = 4, set = 0, scalar) buffer ObjectPropertiesBuffer {
+    ObjectProperties objectProperties[];
+};
+
+// object space center in xyz, radius in w
+layout(binding = 6, set = 0, scalar) buffer Spheres {
+    vec4 spheres[];
+};
+
+vec4 getSphere(uint objectID, uint primitiveID) {
+    return spheres[objectProperties[objectID].firstVertex + primitiveID];
+}
+
+// in object space, where the direction isn't normalized but t is the same as in world space. returns the nearest hit in
+// [tMin, tMax], which is the exit point for rays starting inside, e.g. refracted ones
+bool intersectSphere(vec4 sphere, vec3 origin, vec3 direction, float tMin, float tMax, out float t) {
+    const vec3 oc = origin - sphere.xyz;
+
+    const float a = dot(direction, direction);
+    const float halfB = dot(oc, direction);
+    const float c = dot(oc, oc) - sphere.w * sphere.w;
+    const float discriminant = halfB * halfB - a * c;
+
+    if (discriminant < 0) {
+        return false;
+    }
+
+    const float root = sqrt(discriminant);
+    const float tNear = (-halfB - root) / a;
+    const float tFar = (-halfB + root) / a;
+
+    t = tNear >= tMin && tNear <= tMax ? tNear : tFar;
+    return t >= tMin && t <= tMax;
+}
+
+#endif  // #ifndef REINA_OBJECT_PROPERTIES_H
@@ -0,0 +1,149 @@
+#ifndef REINA_PAYLOAD_H
+#define REINA_PAYLOAD_H
+
+// The ray payload between the raygen shader and the hit and miss shaders. Shaders work on an unpacked PassableInfo and
+// convert at the trace boundary. With PACK_PAYLOAD, the payload is:
+//  - rayOrigin: full precision, since it is offset from the surface by a few ulps
+//  - rayDirection: octahedral, 15 bits per component, plus the sky and skip flags in the top two bits
+//  - color, emission: RGB9E5 (shared exponent), emission already multiplied by its strength
+//  - normal: octahedral, 15 bits per component
+//  - rngState as is
+// which is 12 + 5 * 4 = 32 bytes instead of the 76 of PassableInfo (four vec3, a vec4, a uint and two bools at 4 bytes),
+// so every hit shader writes less and the raygen shader keeps less state alive across traceRayEXT.
+
+#include "shaderCommon.h.glsl"
+#include "../polyglot/common.h"
+
+#if PACK_PAYLOAD
+
+#define PAYLOAD_HIT_SKY (1u << 30)
+#define PAYLOAD_SKIP (1u << 31)
+
+struct Payload {
+    vec3 rayOrigin;
+    uint rayDirectionAndFlags;
+    uint color;
+    uint emission;
+    uint rngState;
+    uint normal;
+};
+
+// zero mantissas with the largest exponent, which packRGB9E5 never produces for a number. a NaN sample has to survive the
+// packing, since the raygen shader drops those instead of accumulating them
+#define RGB9E5_NAN (31u << 27)
+
+// EXT_texture_shared_exponent, with 9 bit mantissas and an exponent bias of 15
+uint packRGB9E5(vec3 rgb) {
+    if (any(isnan(rgb))) {
+        return RGB9E5_NAN;
+    }
+
+    const float maxValue = 65408.0;  // 511 / 512 * 2^16
+    rgb = clamp(rgb, vec3(0.0), vec3(maxValue));
+
+    const float maxChannel = max(rgb.r, max(rgb.g, rgb.b));
+    int exponent = int(floor(log2(max(maxChannel, exp2(-16.0))))) + 16;
+    float scale = exp2(float(exponent - 24));
+
+    // rounding can carry into the next exponent
+    if (uint(round(maxChannel / scale)) == 512) {
+        exponent++;
+        scale *= 2.0;
+    }
+
+    const uvec3 mantissas = uvec3(round(rgb / scale));
+    return mantissas.r | (mantissas.g << 9) | (mantissas.b << 18) | (uint(exponent) << 27);
+}
+
+vec3 unpackRGB9E5(uint bits) {
+    if (bits == RGB9E5_NAN) {
+        return vec3(uintBitsToFloat(0x7fc00000u));
+    }
+
+    const float scale = exp2(float(int(bits >> 27) - 24));
+    return vec3(bits & 0x1ffu, (bits >> 9) & 0x1ffu, (bits >> 18) & 0x1ffu) * scale;
+}
+
+vec2 signNotZero(vec2 v) {
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// the direction doesn't need to be normalized. the result only uses the lower 30 bits
+uint packDirection(vec3 direction) {
+    direction /= max(abs(direction.x) + abs(direction.y) + abs(direction.z), 1e-20);
+    const vec2 folded = direction.z >= 0.0 ? direction.xy : (1.0 - abs(direction.yx)) * signNotZero(direction.xy);
+    const uvec2 quantized = uvec2(round(clamp(folded * 0.5 + 0.5, 0.0, 1.0) * 32767.0));
+
+    return quantized.x | (quantized.y << 15);
+}
+
+vec3 unpackDirection(uint bits) {
+    const vec2 folded = vec2(bits & 0x7fffu, (bits >> 15) & 0x7fffu) / 32767.0 * 2.0 - 1.0;
+    vec3 direction = vec3(folded, 1.0 - abs(folded.x) - abs(folded.y));
+    if (direction.z < 0.0) {
+        direction.xy = (1.0 - abs(direction.yx)) * signNotZero(direction.xy);
+    }
+
+    return normalize(direction);
+}
+
+Payload toPayload(PassableInfo info) {
+    Payload payload;
+    payload.rayOrigin = info.rayOrigin;
+    payload.rayDirectionAndFlags = packDirection(info.rayDirection)
+            | (info.rayHitSky ? PAYLOAD_HIT_SKY : 0u)
+            | (info.skip ? PAYLOAD_SKIP : 0u);
+    payload.color = packRGB9E5(info.color);
+    payload.emission = packRGB9E5(info.emission.xyz * info.emission.w);
+    payload.rngState = info.rngState;
+    payload.normal = packDirection(info.normal);
+    return payload;
+}
+
+PassableInfo fromPayload(Payload payload) {
+    PassableInfo info;
+    info.rayOrigin = payload.rayOrigin;
+    info.rayDirection = unpackDirection(payload.rayDirectionAndFlags);
+    info.rayHitSky = (payload.rayDirectionAndFlags & PAYLOAD_HIT_SKY) != 0;
+    info.skip = (payload.rayDirectionAndFlags & PAYLOAD_SKIP) != 0;
+    info.color = unpackRGB9E5(payload.color);
+    info.emission = vec4(unpackRGB9E5(payload.emission), 1.0);
+    info.rngState = payload.rngState;
+    info.normal = unpackDirection(payload.normal);
+    return info;
+}
+
+// the raygen shader doesn't read anything else of a ray that hit the sky
+void setSkyPayload(inout Payload payload, vec3 skyColor) {
+    payload.rayDirectionAndFlags = PAYLOAD_HIT_SKY;
+    payload.color = packRGB9E5(skyColor);
+}
+
+#else
+
+#define Payload PassableInfo
+
+Payload toPayload(PassableInfo info) {
+    return info;
+}
+
+PassableInfo fromPayload(Payload payload) {
+    return payload;
+}
+
+void setSkyPayload(inout Payload payload, vec3 skyColor) {
+    payload.color = skyColor;
+    payload.rayHitSky = true;
+    payload.skip = false;
+}
+
+#endif  // #if PACK_PAYLOAD
+
+// for hit shaders: a PassableInfo to scatter into, continuing the payload's RNG sequence
+PassableInfo beginScatter(Payload payload) {
+    PassableInfo info;
+    info.rngState = payload.rngState;
+    return info;
+}
+
+#endif  // #ifndef REINA_PAYLOAD_H
@@ -1,44 +1,50 @@
 #version 460
 #extension GL_EXT_ray_tracing : require
+#extension GL_EXT_ray_query : require
 #extension GL_EXT_scalar_block_layout : require
 #extension GL_GOOGLE_include_directive : require
 #include "shaderCommon.h.glsl"
+#include "camera.h.glsl"
+#include "payload.h.glsl"
+#include "accumulation.h.glsl"
 #include "../polyglot/common.h"
 
-// Binding BINDING_IMAGEDATA in set 0 is a storage image with four 32-bit floating-point channels,
-// defined using a uniform image2D variable.
-layout(binding = 0, set = 0, rgba32f) uniform image2D storageImage;
+#ifdef ADAPTIVE_SAMPLING
+#include "adaptive.h.glsl"
+#endif
+
+#ifdef TEMPORAL_REPROJECTION
+#include "reprojection.h.glsl"
+#endif
+
 layout(binding = 1, set = 0) uniform accelerationStructureEXT tlas;
 
+#include "aov.h.glsl"
+
 // Ray payloads are used to send information between shaders.
-layout(location = 0) rayPayloadEXT PassableInfo pld;
+layout(location = 0) rayPayloadEXT Payload pld;
 
 layout (push_constant) uniform PushConsts {
     PushConstantsStruct pushConstants;
 };
 
-struct Ray {
-    vec3 origin;
-    vec3 direction;
+// the surface the camera ray hit, for reprojection and the denoiser's features
+struct PrimaryHit {
+    vec3 position;
+    vec3 normal;
+    vec3 albedo;
+    bool hit;  // false if the camera ray hit the sky
 };
 
-// Uses the Box-Muller transform to return a normally distributed (centered
-// at 0, standard deviation 1) 2D point.
-vec2 randomGaussian(inout uint rngState) {
-    // Almost uniform in (0, 1] - make sure the value is never 0:
-    const float u1 = max(1e-5, stepAndOutputRNGFloat(rngState));
-    const float u2 = stepAndOutputRNGFloat(rngState);  // In [0, 1]
-    const float r = sqrt(-2.0 * log(u1));
-    const float theta = 2 * k_pi * u2;  // Random in [0, 2pi]
-    return r * vec2(cos(theta), sin(theta));
-}
-
-vec3 traceSegments(Ray ray) {
+vec3 traceSegments(Ray ray, out PrimaryHit primaryHit, out uint segmentCount) {
     vec3 accumulatedRayColor = vec3(1.0);
     vec3 incomingLight = vec3(0.0);
+    primaryHit = PrimaryHit(vec3(0.0), vec3(0.0), vec3(0.0), false);
+    segmentCount = 0;
 
-    // BOUNCES_PER_SAMPLE defined in common.h
-    for (int tracedSegments = 0; tracedSegments < BOUNCES_PER_SAMPLE; tracedSegments++) {
+    // at most BOUNCES_PER_SAMPLE, defined in common.h
+    for (uint tracedSegments = 0; tracedSegments < pushConstants.bounces; tracedSegments++) {
+        segmentCount++;
         traceRayEXT(
             tlas,                  // Top-level acceleration structure
             gl_RayFlagsOpaqueEXT,  // Ray flags, here saying "treat all geometry as opaque"
@@ -53,81 +59,79 @@ vec3 traceSegments(Ray ray) {
             0                      // Location of payload
         );
 
-        ray.origin = pld.rayOrigin;
-        ray.direction = pld.rayDirection;
+        const PassableInfo info = fromPayload(pld);
+        ray.origin = info.rayOrigin;
+        ray.direction = info.rayDirection;
 
-        if (pld.skip) {
+        if (info.skip) {
             continue;
         }
 
         #ifdef DEBUG_SHOW_NORMALS
-            incomingLight += pld.color;
+            incomingLight += info.color;
             break;
         #endif
 
-        if (pld.rayHitSky) {
-            incomingLight += pld.color * accumulatedRayColor;
+        if (info.rayHitSky) {
+            incomingLight += info.color * accumulatedRayColor;
             break;
         }
 
-        incomingLight += pld.emission.xyz * pld.emission.w * accumulatedRayColor;
-        accumulatedRayColor *= pld.color;
+        if (!primaryHit.hit) {
+            primaryHit = PrimaryHit(info.rayOrigin, info.normal, info.color, true);
+        }
+
+        incomingLight += info.emission.xyz * info.emission.w * accumulatedRayColor;
+        accumulatedRayColor *= info.color;
     }
 
     return incomingLight;
 }
 
-Ray getStartingRay(
-    vec2 pixel,
-    vec2 resolution,
-    mat4 invView,
-    mat4 invProjection
-) {
-    // Random pixel center for antialiasing
-    vec2 randomPixelCenter = pixel + vec2(0.5) + 0.375 * randomGaussian(pld.rngState);
-
-    vec2 ndc = vec2(
-        (randomPixelCenter.x / resolution.x) * 2.0 - 1.0,
-        -((randomPixelCenter.y / resolution.y) * 2.0 - 1.0)  // Flip y-coordinate so image isn't upside down
-    );
-
-    vec4 clipPos = vec4(ndc, -1.0, 1.0);
-
-    // Unproject from clip space to view (camera) space using the inverse projection matrix.
-    vec4 viewPos = vec4(invProjection * clipPos);
-    viewPos /= viewPos.w;  // Perspective divide
-
-    // Ray direction in view space (camera space origin is at (0,0,0)).
-    vec3 viewDir = normalize(viewPos.xyz);
-
-    // Transform the view-space direction to world space using the inverse view matrix.
-    // Use a w component of 0.0 to indicate that we're transforming a direction.
-    vec4 worldDir4 = vec4(invView * vec4(viewDir, 0.0));
-    vec3 rayDirection = normalize(worldDir4.xyz);
-
-    return Ray(invView[3].xyz, rayDirection);
-}
-
 void main() {
     const ivec2 resolution = imageSize(storageImage);
-    const ivec2 pixel = ivec2(gl_LaunchIDEXT.xy);
+
+#ifdef ADAPTIVE_SAMPLING
+    // the first dispatch after a reset traces every pixel, later ones only the pixels the selection pass listed
+    ivec2 pixel = ivec2(gl_LaunchIDEXT.x, gl_LaunchIDEXT.y) * int(pushConstants.previewScale) + ivec2(0, pushConstants.firstRow);
+    if (pushConstants.accumulatedSamples > 0) {
+        const uint pixelIndex = workListPixels[gl_LaunchIDEXT.x];
+        pixel = ivec2(pixelIndex % uint(resolution.x), pixelIndex / uint(resolution.x));
+    }
+#else
+    const ivec2 pixel = ivec2(gl_LaunchIDEXT.x, gl_LaunchIDEXT.y) * int(pushConstants.previewScale) + ivec2(0, pushConstants.firstRow);
+#endif
+
+    // a preview pixel is sampled over its whole block
+    const float previewOffset = 0.5 * float(pushConstants.previewScale - 1);
 
     if ((pixel.x >= resolution.x) || (pixel.y >= resolution.y)) {
         return;
     }
 
     // State of the random number generator with an initial seed
-    pld.rngState = uint((pushConstants.sampleBatch * resolution.y + pixel.y) * resolution.x + pixel.x);
+    pld.rngState = getInitialRngState(pixel, resolution, pushConstants.sampleBatch, pushConstants.seed);
 
     const float fovVerticalSlope = 1.0 / 5;
 
     int actualSamples = 0;
     vec3 summedPixelColor = vec3(0.0);
-
-    // SAMPLES_PER_PIXEL defined in common.h polyglot file
-    for (int sampleIdx = 0; sampleIdx < SAMPLES_PER_PIXEL; sampleIdx++) {
-        Ray startingRay = getStartingRay(vec2(pixel), vec2(resolution), pushConstants.invView, pushConstants.invProjection);
-        vec3 color = traceSegments(startingRay);
+    vec2 summedLuminanceMoments = vec2(0.0);
+    PrimaryHit primaryHit;
+    Ray primaryRay;
+    uint summedSegments = 0;
+
+    // chosen by the sample scheduler on the host
+    for (uint sampleIdx = 0; sampleIdx < pushConstants.samplesPerPixel; sampleIdx++) {
+        Ray startingRay = getStartingRay(vec2(pixel) + previewOffset, vec2(resolution), pushConstants.invView, pushConstants.invProjection, pld.rngState);
+        PrimaryHit samplePrimaryHit;
+        uint segmentCount;
+        vec3 color = traceSegments(startingRay, samplePrimaryHit, segmentCount);
+        summedSegments += segmentCount;
+        if (sampleIdx == 0) {
+            primaryHit = samplePrimaryHit;
+            primaryRay = startingRay;
+        }
 
         if (any(isnan(color))) {
             continue;
@@ -135,14 +139,94 @@ void main() {
 
         actualSamples++;
         summedPixelColor += color;
+
+#if defined(ADAPTIVE_SAMPLING) || defined(TEMPORAL_REPROJECTION)
+        const float sampleLuminance = luminance(color);
+        summedLuminanceMoments += vec2(sampleLuminance, sampleLuminance * sampleLuminance);
+#endif
+    }
+
+    // the AOVs come from the first dispatch after a reset, which traces every pixel. later samples only refine the color
+    if (enabledAovs != 0 && pushConstants.accumulatedSamples == 0) {
+        const vec3 cameraForward = normalize(-pushConstants.invView[2].xyz);
+        const Aovs aovs = Aovs(
+            primaryHit.albedo,
+            primaryHit.normal,
+            primaryHit.hit ? dot(primaryHit.position - pushConstants.invView[3].xyz, cameraForward) : 0.0,
+            isAovEnabled(AOV_ID) ? traceAovIds(primaryRay.origin, primaryRay.direction) : vec3(-1),
+            float(summedSegments) / float(max(pushConstants.samplesPerPixel, 1u)),
+            primaryHit.hit
+        );
+
+        for (uint y = 0; y < pushConstants.previewScale; y++) {
+            for (uint x = 0; x < pushConstants.previewScale; x++) {
+                const ivec2 blockPixel = pixel + ivec2(x, y);
+                if ((blockPixel.x < resolution.x) && (blockPixel.y < resolution.y)) {
+                    storeAovs(blockPixel, aovs);
+                }
+            }
+        }
+    }
+
+#ifdef ADAPTIVE_SAMPLING
+    // a NaN in the moments would drop the pixel from the work list for good
+    if (actualSamples == 0) {
+        return;
     }
 
-    vec3 finalColor = summedPixelColor / float(actualSamples);
+    // pixels have different sample counts, so the count comes from the pixel's moments
+    vec4 moments = pushConstants.accumulatedSamples > 0 ? imageLoad(momentsImage, pixel) : vec4(0);
+    const uint previousSamples = uint(moments.w);
+
+    moments.xy = accumulateSamples(vec3(moments.xy, 0), previousSamples, vec3(summedLuminanceMoments / float(actualSamples), 0), uint(actualSamples)).xy;
+    moments.w = float(previousSamples + uint(actualSamples));
+    imageStore(momentsImage, pixel, moments);
+
+    Accumulation accumulation = previousSamples > 0 ? loadAccumulation(pixel) : startAccumulation(vec3(0), 0);
+#elif defined(TEMPORAL_REPROJECTION)
+    // a first sample that hit the sky has no position, like a pixel of sky. the denoiser's albedo and normal are the
+    // AOVs written above
+    const vec3 cameraPosition = pushConstants.invView[3].xyz;
+    const vec4 position = vec4(primaryHit.position, primaryHit.hit ? distance(primaryHit.position, cameraPosition) : 0.0);
+    imageStore(positionImage, pixel, position);
+
+    // reprojected pixels start from the history's mean, with its capped sample count
+    Accumulation accumulation = startAccumulation(vec3(0), 0);
+    vec2 prevMoments = vec2(0);
+    if (pushConstants.accumulatedSamples > 0) {
+        accumulation = loadAccumulation(pixel);
+        prevMoments = imageLoad(luminanceMomentsImage, pixel).xy;
+    } else if (pushConstants.reproject != 0) {
+        vec3 historyColor;
+        const uint historySamples = reprojectHistory(position, pushConstants.previousViewProjection, resolution, historyColor, prevMoments);
+        accumulation = startAccumulation(historyColor, historySamples);
+    }
 
-    if (pushConstants.sampleBatch > 0) {
-        vec3 prevColor = imageLoad(storageImage, pixel).rgb;
-        finalColor = (prevColor * pushConstants.sampleBatch + finalColor) / float(pushConstants.sampleBatch + 1);
+    // the moments over all of the pixel's samples, which the denoiser turns into its variance
+    const uint previousSamples = uint(accumulation.samples);
+    vec2 moments = prevMoments;
+    if (actualSamples > 0 && previousSamples > 0) {
+        moments = accumulateSamples(vec3(prevMoments, 0), previousSamples, vec3(summedLuminanceMoments / float(actualSamples), 0), uint(actualSamples)).xy;
+    } else if (actualSamples > 0) {
+        moments = summedLuminanceMoments / float(actualSamples);
     }
 
-    imageStore(storageImage, pixel, vec4(finalColor, 1));
+    imageStore(luminanceMomentsImage, pixel, vec4(moments, 0, 0));
+#else
+    Accumulation accumulation = pushConstants.accumulatedSamples > 0 ? loadAccumulation(pixel) : startAccumulation(vec3(0), 0);
+#endif
+
+    // counted by the samples this dispatch actually added, like the wavefront accumulate pass does, never by
+    // samplesPerPixel: NaN samples are left out of both the sum and the count
+    accumulation = addSamples(accumulation, summedPixelColor, uint(actualSamples));
+
+    // the preview is upscaled by filling the block, so the resolve pass doesn't need to know about it
+    for (uint y = 0; y < pushConstants.previewScale; y++) {
+        for (uint x = 0; x < pushConstants.previewScale; x++) {
+            const ivec2 blockPixel = pixel + ivec2(x, y);
+            if ((blockPixel.x < resolution.x) && (blockPixel.y < resolution.y)) {
+                storeAccumulation(blockPixel, accumulation);
+            }
+        }
+    }
 }
\ No newline at end of file
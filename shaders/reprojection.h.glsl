@@ -0,0 +1,62 @@
+#ifndef REINA_REPROJECTION_H
+#define REINA_REPROJECTION_H
+
+// The positions, moments and history of temporal reprojection (src/graphics/TemporalHistory.h), which the denoiser
+// also filters with, next to the albedo and normal AOVs. Written by raytrace.reproject.rgen, after the scene bindings of
+// set 0. The position is that of the first sample's camera ray.
+
+#include "../polyglot/common.h"
+
+// xyz: world position of the surface the pixel's first camera ray hit, w: its view depth. w is 0 where it hit the sky
+layout(binding = 9, set = 0, rgba32f) uniform image2D positionImage;
+
+// copies of the accumulation image (sums and counts), the position image and the moments, from before the camera moved
+layout(binding = 10, set = 0, rgba32f) uniform image2D historyColorImage;
+layout(binding = 11, set = 0, rgba32f) uniform image2D historyPositionImage;
+
+// x: mean luminance, y: mean squared luminance, over the pixel's samples
+layout(binding = 12, set = 0, rgba32f) uniform image2D luminanceMomentsImage;
+layout(binding = 13, set = 0, rgba32f) uniform image2D historyMomentsImage;
+
+// a copy of the Kahan compensation of the sums (shaders/accumulation.h.glsl), unused without COMPENSATED_ACCUMULATION
+layout(binding = 14, set = 0, rgba32f) uniform image2D historyCompensationImage;
+
+// finds the position's pixel in the history and returns its mean color and sample count. the count is 0 if it was off
+// screen, occluded or another surface
+uint reprojectHistory(vec4 position, mat4 previousViewProjection, ivec2 resolution, out vec3 historyColor, out vec2 historyMoments) {
+    historyColor = vec3(0);
+    historyMoments = vec2(0);
+    if (position.w == 0) {
+        return 0;  // sky pixels converge with the first sample anyway
+    }
+
+    const vec4 previousClip = previousViewProjection * vec4(position.xyz, 1);
+    if (previousClip.w <= 0) {
+        return 0;
+    }
+
+    // the inverse of the mapping in getStartingRay, including the flipped y
+    const vec2 previousNdc = previousClip.xy / previousClip.w;
+    const ivec2 previousPixel = ivec2(floor(vec2(previousNdc.x + 1, 1 - previousNdc.y) * 0.5 * vec2(resolution)));
+    if (any(lessThan(previousPixel, ivec2(0))) || any(greaterThanEqual(previousPixel, resolution))) {
+        return 0;
+    }
+
+    // disocclusion: whatever the pixel showed before is a different surface
+    const vec4 historyPosition = imageLoad(historyPositionImage, previousPixel);
+    if (historyPosition.w == 0 || distance(historyPosition.xyz, position.xyz) > REPROJECTION_TOLERANCE * position.w) {
+        return 0;
+    }
+
+    // the mean as getMean takes it. the reprojected pixel starts a new sum without compensation
+    const vec4 history = imageLoad(historyColorImage, previousPixel);
+#if COMPENSATED_ACCUMULATION
+    historyColor = (history.rgb - imageLoad(historyCompensationImage, previousPixel).rgb) / max(history.a, 1.0);
+#else
+    historyColor = history.rgb / max(history.a, 1.0);
+#endif
+    historyMoments = imageLoad(historyMomentsImage, previousPixel).xy;
+    return min(uint(history.a), REPROJECTION_MAX_SAMPLES);
+}
+
+#endif  // #ifndef REINA_REPROJECTION_H
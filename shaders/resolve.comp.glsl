@@ -0,0 +1,21 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "accumulation.h.glsl"
+
+layout(local_size_x = RESOLVE_WORKGROUP_SIZE, local_size_y = RESOLVE_WORKGROUP_SIZE) in;
+
+// the display image, half the size of the accumulation image
+layout(binding = 0, set = 1, rgba16f) uniform writeonly image2D displayImage;
+
+// divides each pixel's sum by its sample count for the tone mapper
+void main() {
+    const ivec2 resolution = imageSize(storageImage);
+    const ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, resolution))) {
+        return;
+    }
+
+    // the largest half float, so very bright pixels don't turn into infinities
+    const vec3 mean = min(getMean(loadAccumulation(pixel)), vec3(65504.0));
+    imageStore(displayImage, pixel, vec4(mean, 1.0));
+}
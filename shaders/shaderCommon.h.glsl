@@ -13,6 +13,7 @@ struct PassableInfo
     bool rayHitSky;     // True if the ray hit the sky.
     vec4 emission;      // xyz: emission color, w: emission strength
     bool skip;          // If true, the raygen shader knows to skip this ray
+    vec3 normal;        // Shading normal of the hit, for the denoiser's feature buffers.
 };
 
 // Steps the RNG and returns a floating-point value between 0 and 1 inclusive.
@@ -26,4 +27,17 @@ float stepAndOutputRNGFloat(inout uint rngState) {
 
 const float k_pi = 3.14159265;
 
+// the running mean of a pixel after adding batchSamples samples with the mean batchMean
+vec3 accumulateSamples(vec3 previousMean, uint previousSamples, vec3 batchMean, uint batchSamples) {
+    if (previousSamples == 0) {
+        return batchMean;
+    }
+
+    return (previousMean * float(previousSamples) + batchMean * float(batchSamples)) / float(previousSamples + batchSamples);
+}
+
+float luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
 #endif  // #ifndef VK_MINI_PATH_TRACER_SHADER_COMMON_H
\ No newline at end of file
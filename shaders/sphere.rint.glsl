@@ -0,0 +1,17 @@
+#version 460
+#extension GL_EXT_ray_tracing : require
+#extension GL_GOOGLE_include_directive : require
+#include "objectProperties.h.glsl"
+
+// unused, but must match the closest hit shaders
+hitAttributeEXT vec2 attributes;
+
+void main() {
+    const vec4 sphere = getSphere(gl_InstanceCustomIndexEXT, gl_PrimitiveID);
+
+    float t;
+    if (intersectSphere(sphere, gl_ObjectRayOriginEXT, gl_ObjectRayDirectionEXT, gl_RayTminEXT, gl_RayTmaxEXT, t)) {
+        attributes = vec2(0);
+        reportIntersectionEXT(t, 0);
+    }
+}
@@ -0,0 +1,52 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "tonemap.h.glsl"
+
+shared uint localHistogram[TONEMAP_HISTOGRAM_BINS];
+
+vec3 tonemapACES(vec3 color) {
+    // https://knarkowicz.wordpress.com/2016/01/06/aces-filmic-tone-mapping-curve/
+    // todo: implement better ACES tonemapping like at https://github.com/TheRealMJP/BakingLab/blob/master/BakingLab/ACES.hlsl
+    float a = 2.51f;
+    float b = 0.03f;
+    float c = 2.43f;
+    float d = 0.59f;
+    float e = 0.14f;
+
+    return clamp((color * (a * color + b)) / (color * (c * color + d) + e), vec3(0), vec3(1));
+}
+
+uint getHistogramBin(float pixelLuminance) {
+    if (pixelLuminance < exp2(TONEMAP_MIN_LOG_LUMINANCE)) {
+        return 0;
+    }
+
+    const float position = clamp((log2(pixelLuminance) - TONEMAP_MIN_LOG_LUMINANCE) / logLuminanceRange, 0.0, 1.0);
+    return uint(position * float(TONEMAP_HISTOGRAM_BINS - 2)) + 1;
+}
+
+// Exposes and tonemaps the display image into the image that is blitted to the swapchain, and builds the histogram the
+// exposure pass adapts to. The exposure used here is the one adapted to the previous frame, which saves a second pass
+// over the image; with temporal adaptation the one frame lag isn't visible.
+void main() {
+    localHistogram[gl_LocalInvocationIndex] = 0;
+    barrier();
+
+    const ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (all(lessThan(pixel, imageSize(hdrImage)))) {
+        const vec3 color = imageLoad(hdrImage, pixel).rgb;
+        atomicAdd(localHistogram[getHistogramBin(luminance(color))], 1);
+
+        const float exposure = adaptedLuminance > 0.0 ? TONEMAP_KEY / adaptedLuminance : 1.0;
+
+        // todo: there's no sRGB conversion, but from my experience that gives poor contrast. so no sRGB for now
+        imageStore(ldrImage, pixel, vec4(tonemapACES(color * exposure), 1.0));
+    }
+
+    // one global atomic per bin and workgroup instead of one per pixel
+    barrier();
+    const uint count = localHistogram[gl_LocalInvocationIndex];
+    if (count > 0) {
+        atomicAdd(histogram[gl_LocalInvocationIndex], count);
+    }
+}
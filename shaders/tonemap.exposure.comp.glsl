@@ -0,0 +1,44 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "tonemap.h.glsl"
+
+shared vec2 partialSums[TONEMAP_HISTOGRAM_BINS];  // x: bin weighted pixel count, y: pixel count
+
+// A single workgroup with one invocation per bin: reduces the histogram to the geometric mean luminance of the
+// non-black pixels, moves the adapted luminance towards it and clears the histogram for the next frame.
+void main() {
+    const uint bin = gl_LocalInvocationIndex;
+    const float count = float(histogram[bin]);
+    histogram[bin] = 0;
+
+    partialSums[bin] = bin == 0 ? vec2(0.0) : vec2(count * float(bin - 1), count);
+    barrier();
+
+    for (uint stride = TONEMAP_HISTOGRAM_BINS / 2; stride > 0; stride /= 2) {
+        if (bin < stride) {
+            partialSums[bin] += partialSums[bin + stride];
+        }
+        barrier();
+    }
+
+    if (bin != 0) {
+        return;
+    }
+
+    // an all black image keeps the previous exposure
+    const vec2 sums = partialSums[0];
+    if (sums.y == 0.0) {
+        return;
+    }
+
+    // the bin centers of getHistogramBin
+    const float meanPosition = (sums.x / sums.y + 0.5) / float(TONEMAP_HISTOGRAM_BINS - 2);
+    const float targetLuminance = exp2(meanPosition * logLuminanceRange + TONEMAP_MIN_LOG_LUMINANCE);
+
+    if (adaptedLuminance <= 0.0) {
+        adaptedLuminance = targetLuminance;
+    } else {
+        const float adaptation = 1.0 - exp(-pushConstants.deltaTime * TONEMAP_ADAPTATION_RATE);
+        adaptedLuminance += (targetLuminance - adaptedLuminance) * adaptation;
+    }
+}
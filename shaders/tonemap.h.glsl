@@ -0,0 +1,29 @@
+#ifndef REINA_TONEMAP_H
+#define REINA_TONEMAP_H
+
+// Shared by the passes of the tone mapper (src/graphics/ToneMapper.h), which has a descriptor set of its own.
+
+#include "shaderCommon.h.glsl"
+#include "../polyglot/common.h"
+
+layout(local_size_x = TONEMAP_WORKGROUP_SIZE, local_size_y = TONEMAP_WORKGROUP_SIZE) in;
+
+layout(binding = 0, set = 0, rgba16f) uniform readonly image2D hdrImage;  // the display image, see Accumulator
+layout(binding = 1, set = 0, rgba8) uniform writeonly image2D ldrImage;   // blitted to the swapchain
+
+// pixel counts of the frame's log2 luminances, added up by the tonemap pass and cleared by the exposure pass
+layout(binding = 2, set = 0) buffer Histogram {
+    uint histogram[TONEMAP_HISTOGRAM_BINS];
+};
+
+layout(binding = 3, set = 0) buffer Exposure {
+    float adaptedLuminance;  // 0 until the first exposure pass
+};
+
+layout(push_constant) uniform PushConsts {
+    ToneMapPushConstantsStruct pushConstants;
+};
+
+const float logLuminanceRange = TONEMAP_MAX_LOG_LUMINANCE - TONEMAP_MIN_LOG_LUMINANCE;
+
+#endif  // #ifndef REINA_TONEMAP_H
@@ -0,0 +1,27 @@
+#ifndef REINA_VERTEX_COMPRESSION_H
+#define REINA_VERTEX_COMPRESSION_H
+
+// Decoders for the compressed vertex formats written by src/graphics/VertexCompression.cpp
+
+// Positions are 16-bit SNORMs relative to the mesh bounds. The bounds are folded into the instance transform, so the
+// result is already in the same (quantized) object space as the BLAS.
+vec3 unpackQuantizedPosition(uvec2 packed) {
+    return vec3(unpackSnorm2x16(packed.x), unpackSnorm2x16(packed.y).x);
+}
+
+vec2 signNotZero(vec2 v) {
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec3 decodeOctahedral(uint encoded) {
+    const vec2 e = unpackSnorm2x16(encoded);
+    vec3 normal = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+
+    if (normal.z < 0.0) {
+        normal.xy = (1.0 - abs(normal.yx)) * signNotZero(normal.xy);
+    }
+
+    return normalize(normal);
+}
+
+#endif  // #ifndef REINA_VERTEX_COMPRESSION_H
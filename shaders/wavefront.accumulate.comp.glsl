@@ -0,0 +1,30 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "wavefrontCommon.h.glsl"
+#include "shaderCommon.h.glsl"
+
+// adds the finished sample of every pixel to its sum, and after the batch's last sample adds the batch to the
+// accumulation image the same way the raygen shader does
+void main() {
+    const ivec2 resolution = imageSize(storageImage);
+    const uint pathIndex = gl_GlobalInvocationID.x;
+
+    if (pathIndex >= getPathCount()) {
+        return;
+    }
+
+    const vec3 radiance = paths[pathIndex].radiance;
+    if (!any(isnan(radiance))) {
+        sampleSums[pathIndex] += vec4(radiance, 1);
+    }
+
+    if (pushConstants.sampleIndex < pushConstants.frame.samplesPerPixel - 1) {
+        return;
+    }
+
+    const ivec2 pixel = ivec2(pathIndex % uint(resolution.x), pathIndex / uint(resolution.x));
+    const vec4 batch = sampleSums[pathIndex];
+
+    Accumulation accumulation = pushConstants.frame.accumulatedSamples > 0 ? loadAccumulation(pixel) : startAccumulation(vec3(0), 0);
+    storeAccumulation(pixel, addSamples(accumulation, batch.rgb, uint(batch.a)));
+}
\ No newline at end of file
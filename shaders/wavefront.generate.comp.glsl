@@ -0,0 +1,31 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "wavefrontCommon.h.glsl"
+#include "camera.h.glsl"
+
+// starts one sample of every pixel and queues all paths for the first bounce
+void main() {
+    const ivec2 resolution = imageSize(storageImage);
+    const uint pathIndex = gl_GlobalInvocationID.x;
+
+    if (pathIndex >= getPathCount()) {
+        return;
+    }
+
+    const ivec2 pixel = ivec2(pathIndex % uint(resolution.x), pathIndex / uint(resolution.x));
+    const PushConstantsStruct frame = pushConstants.frame;
+
+    // like in the raygen shader, the RNG state carries over from one sample of a pixel to the next
+    uint rngState;
+    if (pushConstants.sampleIndex == 0) {
+        rngState = getInitialRngState(pixel, resolution, frame.sampleBatch, frame.seed);
+        sampleSums[pathIndex] = vec4(0);
+    } else {
+        rngState = paths[pathIndex].rngState;
+    }
+
+    const Ray ray = getStartingRay(vec2(pixel), vec2(resolution), frame.invView, frame.invProjection, rngState);
+    paths[pathIndex] = WavefrontPath(ray.origin, ray.direction, vec3(1), vec3(0), rngState);
+
+    pushToQueue(RAY_QUEUE(0), pathIndex);
+}
@@ -0,0 +1,69 @@
+#version 460
+#extension GL_EXT_ray_query : require
+#extension GL_GOOGLE_include_directive : require
+#include "wavefrontCommon.h.glsl"
+#include "hitInfo.h.glsl"
+
+layout(binding = 1, set = 0) uniform accelerationStructureEXT tlas;
+
+// traces the paths of the current ray queue and sorts the hits into the material queues. misses end the path
+void main() {
+    const uint queue = RAY_QUEUE(pushConstants.rayQueue);
+    if (gl_GlobalInvocationID.x >= queueCounters[queue].count) {
+        return;
+    }
+
+    const uint pathIndex = getQueuedPath(queue, gl_GlobalInvocationID.x);
+    const WavefrontPath path = paths[pathIndex];
+
+    rayQueryEXT rayQuery;
+    rayQueryInitializeEXT(rayQuery, tlas, gl_RayFlagsOpaqueEXT, 0xFF, path.origin, 0.0, path.direction, 10000.0);
+
+    while (rayQueryProceedEXT(rayQuery)) {
+        // opaque triangles are committed by the traversal, only the spheres' AABBs need an intersection test here
+        if (rayQueryGetIntersectionTypeEXT(rayQuery, false) != gl_RayQueryCandidateIntersectionAABBEXT) {
+            continue;
+        }
+
+        const vec4 sphere = getSphere(rayQueryGetIntersectionInstanceCustomIndexEXT(rayQuery, false), rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, false));
+        const float tMax = rayQueryGetIntersectionTypeEXT(rayQuery, true) == gl_RayQueryCommittedIntersectionNoneEXT
+                ? 10000.0
+                : rayQueryGetIntersectionTEXT(rayQuery, true);
+
+        float t;
+        if (intersectSphere(sphere, rayQueryGetIntersectionObjectRayOriginEXT(rayQuery, false), rayQueryGetIntersectionObjectRayDirectionEXT(rayQuery, false), rayQueryGetRayTMinEXT(rayQuery), tMax, t)) {
+            rayQueryGenerateIntersectionEXT(rayQuery, t);
+        }
+    }
+
+    const uint committedType = rayQueryGetIntersectionTypeEXT(rayQuery, true);
+
+    // the sky is black (see raytrace.rmiss.glsl), so a miss adds nothing
+    if (committedType == gl_RayQueryCommittedIntersectionNoneEXT) {
+        return;
+    }
+
+    const uint objectID = rayQueryGetIntersectionInstanceCustomIndexEXT(rayQuery, true);
+    const uint primitiveID = rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, true);
+    const mat4x3 worldToObject = rayQueryGetIntersectionWorldToObjectEXT(rayQuery, true);
+
+    HitInfo hitInfo;
+    if (committedType == gl_RayQueryCommittedIntersectionGeneratedEXT) {
+        hitInfo = getSphereHitInfo(
+                objectID, primitiveID, rayQueryGetIntersectionTEXT(rayQuery, true),
+                rayQueryGetIntersectionObjectRayOriginEXT(rayQuery, true), rayQueryGetIntersectionObjectRayDirectionEXT(rayQuery, true),
+                path.origin, path.direction, worldToObject
+        );
+    } else {
+        hitInfo = getTriangleHitInfo(
+                objectID, primitiveID, rayQueryGetIntersectionBarycentricsEXT(rayQuery, true),
+                rayQueryGetIntersectionObjectToWorldEXT(rayQuery, true), worldToObject, path.direction
+        );
+    }
+
+    hits[pathIndex] = WavefrontHit(hitInfo.worldPosition, hitInfo.worldNormal, hitInfo.geometricNormal, objectID, hitInfo.frontFace ? 1u : 0u);
+
+    // the instance's hit group is its material, offset by MATERIAL_COUNT for spheres (see SPHERE_HIT_GROUPS_OFFSET)
+    const uint hitGroup = rayQueryGetIntersectionInstanceShaderBindingTableRecordOffsetEXT(rayQuery, true);
+    pushToQueue(MATERIAL_QUEUE(hitGroup % MATERIAL_COUNT), pathIndex);
+}
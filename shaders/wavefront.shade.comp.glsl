@@ -0,0 +1,54 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+#include "wavefrontCommon.h.glsl"
+#include "materials.h.glsl"
+#include "payload.h.glsl"
+
+// Shades the hits of one material queue, compiled once per material with MATERIAL set to one of the MATERIAL_ defines,
+// so every thread of a group runs the same material code. All paths continue into the next ray queue.
+void main() {
+    const uint queue = MATERIAL_QUEUE(MATERIAL);
+    if (gl_GlobalInvocationID.x >= queueCounters[queue].count) {
+        return;
+    }
+
+    const uint pathIndex = getQueuedPath(queue, gl_GlobalInvocationID.x);
+    WavefrontPath path = paths[pathIndex];
+    const WavefrontHit hit = hits[pathIndex];
+
+    // the materials only use these
+    HitInfo hitInfo;
+    hitInfo.worldPosition = hit.worldPosition;
+    hitInfo.worldNormal = hit.worldNormal;
+    hitInfo.geometricNormal = hit.geometricNormal;
+    hitInfo.frontFace = hit.frontFace != 0;
+
+    PassableInfo info;
+    info.rngState = path.rngState;
+
+#if MATERIAL == MATERIAL_LAMBERTIAN
+    scatterLambertian(hitInfo, hit.objectID, path.direction, info);
+#elif MATERIAL == MATERIAL_METAL
+    scatterMetal(hitInfo, hit.objectID, path.direction, info);
+#elif MATERIAL == MATERIAL_DIELECTRIC
+    scatterDielectric(hitInfo, hit.objectID, path.direction, info);
+#else
+#error "MATERIAL must be one of the MATERIAL_ defines"
+#endif
+
+    // the megakernel's hit shaders hand the result back through the payload, so round trip it for the same image
+    info = fromPayload(toPayload(info));
+
+    // the same as a bounce of traceSegments in raytrace.rgen.glsl
+    if (!info.skip) {
+        path.radiance += info.emission.xyz * info.emission.w * path.throughput;
+        path.throughput *= info.color;
+    }
+
+    path.origin = info.rayOrigin;
+    path.direction = info.rayDirection;
+    path.rngState = info.rngState;
+    paths[pathIndex] = path;
+
+    pushToQueue(RAY_QUEUE(1 - pushConstants.rayQueue), pathIndex);
+}
@@ -0,0 +1,64 @@
+#ifndef REINA_WAVEFRONT_COMMON_H
+#define REINA_WAVEFRONT_COMMON_H
+
+// Buffers of the wavefront integrator (set 1, see src/graphics/WavefrontIntegrator.h). Set 0 is the scene descriptor
+// set shared with the ray tracing pipeline. There is one path per pixel, so path indices are pixel indices.
+
+#extension GL_EXT_scalar_block_layout : require
+#include "../polyglot/common.h"
+
+layout(local_size_x = WAVEFRONT_WORKGROUP_SIZE) in;
+
+#include "accumulation.h.glsl"
+
+layout(push_constant) uniform PushConsts {
+    WavefrontPushConstantsStruct pushConstants;
+};
+
+layout(binding = 0, set = 1, scalar) buffer Paths {
+    WavefrontPath paths[];
+};
+
+// written by the intersection kernel, read by the shading kernels
+layout(binding = 1, set = 1, scalar) buffer Hits {
+    WavefrontHit hits[];
+};
+
+// WAVEFRONT_QUEUE_COUNT queues of path indices, one after the other, each with room for every path
+layout(binding = 2, set = 1, scalar) buffer Queues {
+    uint queues[];
+};
+
+layout(binding = 3, set = 1, scalar) buffer QueueCounters {
+    WavefrontQueueCounter queueCounters[];
+};
+
+// rgb: the summed radiance of the batch's samples so far, a: the number of samples that weren't NaN
+layout(binding = 4, set = 1, scalar) buffer SampleSums {
+    vec4 sampleSums[];
+};
+
+#define RAY_QUEUE(parity) (parity)
+#define MATERIAL_QUEUE(material) (2 + (material))
+
+uint getPathCount() {
+    const ivec2 resolution = imageSize(storageImage);
+    return uint(resolution.x * resolution.y);
+}
+
+uint getQueuedPath(uint queue, uint slot) {
+    return queues[queue * getPathCount() + slot];
+}
+
+// appends to a queue, which keeps the live paths densely packed. the group count of the indirect dispatch that will
+// consume the queue is bumped by whoever takes the first slot of a group
+void pushToQueue(uint queue, uint pathIndex) {
+    const uint slot = atomicAdd(queueCounters[queue].count, 1);
+    if (slot % WAVEFRONT_WORKGROUP_SIZE == 0) {
+        atomicAdd(queueCounters[queue].groupCountX, 1);
+    }
+
+    queues[queue * getPathCount() + slot] = pathIndex;
+}
+
+#endif  // #ifndef REINA_WAVEFRONT_COMMON_H
@@ -112,12 +112,12 @@ VkDescriptorSet reina::core::DescriptorSet::getDescriptorSet() const {
     return descriptorSet;
 }
 
-void reina::core::DescriptorSet::bind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout) {
+void reina::core::DescriptorSet::bind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t setIndex) {
     vkCmdBindDescriptorSets(
             cmdBuffer,
             bindPoint,
             pipelineLayout,
-            0,
+            setIndex,
             1,
             &descriptorSet,
             0,
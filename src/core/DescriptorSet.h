@@ -11,7 +11,7 @@ namespace reina::core {
         uint32_t bindingPoint;
         VkDescriptorType type;
         uint32_t descriptorCount;
-        VkShaderStageFlagBits stageFlags;
+        VkShaderStageFlags stageFlags;
 
         [[nodiscard]] VkDescriptorSetLayoutBinding toLayoutBinding() const;
     };
@@ -28,7 +28,7 @@ namespace reina::core {
     public:
         DescriptorSet(VkDevice logicalDevice, const std::vector<Binding>& bindings);
 
-        void bind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout);
+        void bind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t setIndex = 0);
         void writeBinding(VkDevice logicalDevice, int bindingPoint, VkDescriptorImageInfo* imageInfo,
                           VkDescriptorBufferInfo* bufferInfo, VkBufferView* bufferView, void* next);
 
@@ -0,0 +1,66 @@
+#include "GpuTimer.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+reina::core::GpuTimer::GpuTimer(VkDevice logicalDevice, VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    // without timestamps on the graphics queue, read() never has a result
+    if (!properties.limits.timestampComputeAndGraphics) {
+        return;
+    }
+
+    secondsPerTick = properties.limits.timestampPeriod * 1e-9;
+
+    VkQueryPoolCreateInfo queryPoolInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = 2
+    };
+
+    if (vkCreateQueryPool(logicalDevice, &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Cannot create timestamp query pool");
+    }
+}
+
+void reina::core::GpuTimer::begin(VkCommandBuffer cmdBuffer) {
+    if (queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdResetQueryPool(cmdBuffer, queryPool, 0, 2);
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+}
+
+void reina::core::GpuTimer::end(VkCommandBuffer cmdBuffer) {
+    if (queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+    recorded = true;
+}
+
+std::optional<double> reina::core::GpuTimer::read(VkDevice logicalDevice) {
+    if (!recorded) {
+        return std::nullopt;
+    }
+
+    uint64_t timestamps[2];
+    VkResult result = vkGetQueryPoolResults(logicalDevice, queryPool, 0, 2, sizeof(timestamps), timestamps,
+                                            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return std::nullopt;
+    }
+
+    recorded = false;
+    return static_cast<double>(timestamps[1] - timestamps[0]) * secondsPerTick;
+}
+
+void reina::core::GpuTimer::destroy(VkDevice logicalDevice) {
+    if (queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(logicalDevice, queryPool, nullptr);
+    }
+}
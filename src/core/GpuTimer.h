@@ -0,0 +1,38 @@
+#ifndef REINA_VK_GPUTIMER_H
+#define REINA_VK_GPUTIMER_H
+
+#include <vulkan/vulkan.h>
+
+#include <optional>
+
+namespace reina::core {
+    /**
+     * Measures the GPU time between two points of a command buffer with a pair of timestamp queries. Only one
+     * measurement is in flight at a time, which matches the single command buffer of the render loop.
+     */
+    class GpuTimer {
+    public:
+        GpuTimer(VkDevice logicalDevice, VkPhysicalDevice physicalDevice);
+
+        /**
+         * Resets the queries and writes the first timestamp. Must be recorded outside a render pass.
+         */
+        void begin(VkCommandBuffer cmdBuffer);
+        void end(VkCommandBuffer cmdBuffer);
+
+        /**
+         * The seconds between begin and end of the last recorded measurement, once its command buffer has finished.
+         * Empty if nothing was recorded yet, the results aren't available or the device has no timestamps.
+         */
+        [[nodiscard]] std::optional<double> read(VkDevice logicalDevice);
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+        double secondsPerTick = 0;
+        bool recorded = false;
+    };
+}
+
+#endif //REINA_VK_GPUTIMER_H
@@ -0,0 +1,117 @@
+#include "PipelineCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    std::string getCacheFileName(const VkPhysicalDeviceProperties& properties) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "pipeline_cache_%04x_%04x.bin", properties.vendorID, properties.deviceID);
+        return name;
+    }
+
+    // drivers are supposed to reject foreign data themselves, but not all of them check as thoroughly
+    bool matchesDevice(const std::vector<char>& data, const VkPhysicalDeviceProperties& properties) {
+        VkPipelineCacheHeaderVersionOne header;
+        if (data.size() < sizeof(header)) {
+            return false;
+        }
+
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        return header.headerSize >= sizeof(header)
+               && header.headerSize <= data.size()
+               && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+               && header.vendorID == properties.vendorID
+               && header.deviceID == properties.deviceID
+               && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+}
+
+reina::core::PipelineCache::PipelineCache(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::string& directory) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    std::vector<char> data;
+    if (!directory.empty()) {
+        path = (std::filesystem::path(directory) / getCacheFileName(properties)).string();
+
+        std::ifstream file(path, std::ios::binary);
+        if (file) {
+            data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        if (!data.empty() && !matchesDevice(data, properties)) {
+            std::cerr << "Ignoring pipeline cache " << path << ", it was created by a different device or driver\n";
+            data.clear();
+        }
+    }
+
+    warm = !data.empty();
+
+    VkPipelineCacheCreateInfo createInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = data.size(),
+            .pInitialData = data.empty() ? nullptr : data.data()
+    };
+
+    if (vkCreatePipelineCache(logicalDevice, &createInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache");
+    }
+}
+
+void reina::core::PipelineCache::save(VkDevice logicalDevice) const {
+    if (path.empty()) {
+        return;
+    }
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &size, nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to get pipeline cache size");
+    }
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &size, data.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to get pipeline cache data");
+    }
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(size));
+
+        if (!file) {
+            std::cerr << "Could not write pipeline cache " << temporaryPath << "\n";
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::cerr << "Could not replace pipeline cache " << path << ": " << error.message() << "\n";
+    }
+}
+
+VkPipelineCache reina::core::PipelineCache::getHandle() const {
+    return pipelineCache;
+}
+
+bool reina::core::PipelineCache::isWarm() const {
+    return warm;
+}
+
+const std::string& reina::core::PipelineCache::getPath() const {
+    return path;
+}
+
+void reina::core::PipelineCache::destroy(VkDevice logicalDevice) {
+    vkDestroyPipelineCache(logicalDevice, pipelineCache, nullptr);
+    pipelineCache = VK_NULL_HANDLE;
+}
@@ -0,0 +1,40 @@
+#ifndef REINA_VK_PIPELINECACHE_H
+#define REINA_VK_PIPELINECACHE_H
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+
+namespace reina::core {
+    /**
+     * A VkPipelineCache backed by a file per device, so the driver can skip compiling the pipelines on later launches.
+     * The file is named after the vendor and device ID, and only used if its header also matches the driver's
+     * pipelineCacheUUID, which changes with driver updates. Anything else starts an empty cache.
+     */
+    class PipelineCache {
+    public:
+        /**
+         * @param directory where the cache file is read from and saved to. Empty disables loading and saving
+         */
+        PipelineCache(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::string& directory);
+
+        /**
+         * Writes the cache to a temporary file first and then replaces the old one, so an interrupted save can't leave
+         * a truncated cache behind. Failing to save only prints a warning.
+         */
+        void save(VkDevice logicalDevice) const;
+
+        [[nodiscard]] VkPipelineCache getHandle() const;
+        [[nodiscard]] bool isWarm() const;  // if valid data was loaded from the file
+        [[nodiscard]] const std::string& getPath() const;
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+        std::string path;
+        bool warm = false;
+    };
+}
+
+#endif //REINA_VK_PIPELINECACHE_H
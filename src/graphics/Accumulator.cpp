@@ -0,0 +1,105 @@
+#include "Accumulator.h"
+
+#include <array>
+#include <stdexcept>
+
+#include "Shader.h"
+#include "../../polyglot/common.h"
+
+namespace {
+    constexpr uint32_t COMPENSATION_BINDING = 20;
+    constexpr VkFormat DISPLAY_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+}
+
+reina::graphics::Accumulator::Accumulator(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, uint32_t width, uint32_t height)
+    : width(width), height(height),
+      // without compensation the binding is unused, but must still be valid
+      compensationImage(COMPENSATED_ACCUMULATION
+              ? vktools::createRtImage(logicalDevice, physicalDevice, width, height)
+              : vktools::createRtImage(logicalDevice, physicalDevice, 1, 1)),
+      compensationView(vktools::createRtImageView(logicalDevice, compensationImage.image)),
+      displayImage(vktools::createRtImage(logicalDevice, physicalDevice, width, height, DISPLAY_FORMAT)),
+      displayView(vktools::createRtImageView(logicalDevice, displayImage.image, DISPLAY_FORMAT)),
+      descriptorSet(logicalDevice, {
+              reina::core::Binding{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT}
+      }) {
+    VkDescriptorImageInfo imageInfo{.imageView = displayView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    descriptorSet.writeBinding(logicalDevice, 0, &imageInfo, nullptr, nullptr, nullptr);
+
+    VkDescriptorSetLayout setLayouts[] = {sceneDescriptorSet.getLayout(), descriptorSet.getLayout()};
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 2,
+            .pSetLayouts = setLayouts
+    };
+
+    if (vkCreatePipelineLayout(logicalDevice, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Cannot create resolve pipeline layout");
+    }
+
+    Shader shader{logicalDevice, shaderLoader.load("resolve.comp"), VK_SHADER_STAGE_COMPUTE_BIT};
+    resolvePipeline = vktools::createComputePipeline(logicalDevice, pipelineCache, pipelineLayout, shader);
+    shader.destroy(logicalDevice);
+}
+
+std::vector<reina::core::Binding> reina::graphics::Accumulator::getBindings() {
+    return {
+            reina::core::Binding{COMPENSATION_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT}
+    };
+}
+
+void reina::graphics::Accumulator::writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const {
+    VkDescriptorImageInfo imageInfo{.imageView = compensationView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    sceneDescriptorSet.writeBinding(logicalDevice, COMPENSATION_BINDING, &imageInfo, nullptr, nullptr, nullptr);
+}
+
+void reina::graphics::Accumulator::recordInitialization(VkCommandBuffer cmdBuffer) const {
+    // the compensation is only read for pixels that already have samples, so neither image needs clearing
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    std::array<VkImage, 2> images{compensationImage.image, displayImage.image};
+    for (size_t i = 0; i < images.size(); i++) {
+        barriers[i] = vktools::imageBarrier(images[i], 0, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+}
+
+void reina::graphics::Accumulator::recordResolve(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet) {
+    // the dispatch (ray tracing or wavefront) wrote the sums, the previous frame's tone mapper read the display image
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    sceneDescriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0);
+    descriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 1);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, resolvePipeline);
+    vkCmdDispatch(cmdBuffer, (width + RESOLVE_WORKGROUP_SIZE - 1) / RESOLVE_WORKGROUP_SIZE, (height + RESOLVE_WORKGROUP_SIZE - 1) / RESOLVE_WORKGROUP_SIZE, 1);
+
+    vktools::memoryBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+VkImageView reina::graphics::Accumulator::getDisplayView() const {
+    return displayView;
+}
+
+VkImage reina::graphics::Accumulator::getCompensationImage() const {
+    return compensationImage.image;
+}
+
+void reina::graphics::Accumulator::destroy(VkDevice logicalDevice) {
+    vkDestroyPipeline(logicalDevice, resolvePipeline, nullptr);
+    vkDestroyPipelineLayout(logicalDevice, pipelineLayout, nullptr);
+    descriptorSet.destroy(logicalDevice);
+
+    vkDestroyImageView(logicalDevice, compensationView, nullptr);
+    vkDestroyImage(logicalDevice, compensationImage.image, nullptr);
+    vkFreeMemory(logicalDevice, compensationImage.imageMemory, nullptr);
+    vkDestroyImageView(logicalDevice, displayView, nullptr);
+    vkDestroyImage(logicalDevice, displayImage.image, nullptr);
+    vkFreeMemory(logicalDevice, displayImage.imageMemory, nullptr);
+}
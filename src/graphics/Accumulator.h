@@ -0,0 +1,61 @@
+#ifndef REINA_VK_ACCUMULATOR_H
+#define REINA_VK_ACCUMULATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+#include "../core/DescriptorSet.h"
+#include "../tools/vktools.h"
+#include "ShaderLoader.h"
+
+namespace reina::graphics {
+    /**
+     * The ray traced image is an accumulation image: each pixel's sum of samples in rgb and their count in alpha,
+     * instead of a running mean that every batch rounds again. With COMPENSATED_ACCUMULATION (polyglot/common.h) the
+     * sums are Kahan compensated, with the compensation in a second image, so even very long renders converge to the
+     * same value as a double precision sum. See shaders/accumulation.h.glsl.
+     *
+     * A compute pass resolves the sums to means in an rgba16f display image, which the tone mapper reads at half the
+     * bandwidth of the accumulation image. With the denoiser, its final pass writes the display image instead.
+     *
+     * Adds binding 20 to the ray tracing descriptor set.
+     */
+    class Accumulator {
+    public:
+        Accumulator(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, uint32_t width, uint32_t height);
+
+        [[nodiscard]] static std::vector<reina::core::Binding> getBindings();
+        void writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const;
+
+        /**
+         * Moves the images into the general layout. Must be recorded before the first dispatch.
+         */
+        void recordInitialization(VkCommandBuffer cmdBuffer) const;
+
+        /**
+         * Records the resolve pass after a dispatch, and synchronizes the display image with the tone mapper.
+         */
+        void recordResolve(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet);
+
+        [[nodiscard]] VkImageView getDisplayView() const;
+        [[nodiscard]] VkImage getCompensationImage() const;  // only holds the compensation with COMPENSATED_ACCUMULATION
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        uint32_t width;
+        uint32_t height;
+
+        vktools::ImageObjects compensationImage;
+        VkImageView compensationView;
+        vktools::ImageObjects displayImage;
+        VkImageView displayView;
+        reina::core::DescriptorSet descriptorSet;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline resolvePipeline = VK_NULL_HANDLE;
+    };
+}
+
+#endif //REINA_VK_ACCUMULATOR_H
@@ -0,0 +1,146 @@
+#include "AdaptiveSampler.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Shader.h"
+#include "../../polyglot/common.h"
+
+namespace {
+    constexpr uint32_t SELECT_GROUP_SIZE = 8;  // local size of adaptive.select.comp.glsl in x and y
+}
+
+reina::graphics::AdaptiveSampler::AdaptiveSampler(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, uint32_t width, uint32_t height, float threshold)
+    : width(width), height(height), threshold(threshold),
+      momentsImage(vktools::createRtImage(logicalDevice, physicalDevice, width, height)),
+      momentsImageView(vktools::createRtImageView(logicalDevice, momentsImage.image)),
+      workList(logicalDevice, physicalDevice, sizeof(VkTraceRaysIndirectCommandKHR) + sizeof(uint32_t) * width * height,
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+               VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+      listedPixelsReadback(logicalDevice, physicalDevice, sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+    VkPhysicalDeviceRayTracingPipelineFeaturesKHR rtPipelineFeatures{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR
+    };
+    VkPhysicalDeviceFeatures2 features{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &rtPipelineFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    if (!rtPipelineFeatures.rayTracingPipelineTraceRaysIndirect) {
+        throw std::runtime_error("Adaptive sampling needs indirect trace rays, which the physical device doesn't support");
+    }
+
+    VkDescriptorSetLayout setLayout = sceneDescriptorSet.getLayout();
+    VkPushConstantRange pushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = sizeof(AdaptivePushConstantsStruct)
+    };
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 1,
+            .pSetLayouts = &setLayout,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange
+    };
+
+    if (vkCreatePipelineLayout(logicalDevice, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Cannot create adaptive sampling pipeline layout");
+    }
+
+    Shader selectShader{logicalDevice, shaderLoader.load("adaptive.select.comp"), VK_SHADER_STAGE_COMPUTE_BIT};
+    selectPipeline = vktools::createComputePipeline(logicalDevice, pipelineCache, pipelineLayout, selectShader);
+    selectShader.destroy(logicalDevice);
+}
+
+std::vector<reina::core::Binding> reina::graphics::AdaptiveSampler::getBindings() {
+    return {
+            reina::core::Binding{7, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT},
+            reina::core::Binding{8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT}
+    };
+}
+
+void reina::graphics::AdaptiveSampler::writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const {
+    VkDescriptorImageInfo momentsInfo{.imageView = momentsImageView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    sceneDescriptorSet.writeBinding(logicalDevice, 7, &momentsInfo, nullptr, nullptr, nullptr);
+
+    VkDescriptorBufferInfo workListInfo{.buffer = workList.getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    sceneDescriptorSet.writeBinding(logicalDevice, 8, nullptr, &workListInfo, nullptr, nullptr);
+}
+
+void reina::graphics::AdaptiveSampler::recordInitialization(VkCommandBuffer cmdBuffer) const {
+    VkImageMemoryBarrier barrier = vktools::imageBarrier(momentsImage.image, 0, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                                         VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void reina::graphics::AdaptiveSampler::recordSelection(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet) const {
+    // the previous dispatch wrote the moments, and read the list and its command
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    // an empty list, traced as a width x 1 x 1 launch
+    VkTraceRaysIndirectCommandKHR emptyCommand{0, 1, 1};
+    vkCmdUpdateBuffer(cmdBuffer, workList.getHandle(), 0, sizeof(emptyCommand), &emptyCommand);
+
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    AdaptivePushConstantsStruct pushConstants{threshold};
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, selectPipeline);
+    sceneDescriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout);
+    vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+    vkCmdDispatch(cmdBuffer, (width + SELECT_GROUP_SIZE - 1) / SELECT_GROUP_SIZE, (height + SELECT_GROUP_SIZE - 1) / SELECT_GROUP_SIZE, 1);
+
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+}
+
+void reina::graphics::AdaptiveSampler::recordReadback(VkCommandBuffer cmdBuffer) const {
+    VkBufferCopy copy{.srcOffset = 0, .dstOffset = 0, .size = sizeof(uint32_t)};
+    vkCmdCopyBuffer(cmdBuffer, workList.getHandle(), listedPixelsReadback.getHandle(), 1, &copy);
+
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+}
+
+uint32_t reina::graphics::AdaptiveSampler::getListedPixels(VkDevice logicalDevice) const {
+    void* mapped;
+    if (vkMapMemory(logicalDevice, listedPixelsReadback.getDeviceMemory(), 0, sizeof(uint32_t), 0, &mapped) != VK_SUCCESS) {
+        throw std::runtime_error("Cannot map the adaptive sampling readback buffer");
+    }
+
+    uint32_t listedPixels;
+    std::memcpy(&listedPixels, mapped, sizeof(listedPixels));
+    vkUnmapMemory(logicalDevice, listedPixelsReadback.getDeviceMemory());
+
+    return listedPixels;
+}
+
+VkDeviceAddress reina::graphics::AdaptiveSampler::getTraceCommandAddress(VkDevice logicalDevice) const {
+    return workList.getDeviceAddress(logicalDevice);  // the command is the start of the list
+}
+
+void reina::graphics::AdaptiveSampler::destroy(VkDevice logicalDevice) {
+    vkDestroyPipeline(logicalDevice, selectPipeline, nullptr);
+    vkDestroyPipelineLayout(logicalDevice, pipelineLayout, nullptr);
+
+    workList.destroy(logicalDevice);
+    listedPixelsReadback.destroy(logicalDevice);
+    vkDestroyImageView(logicalDevice, momentsImageView, nullptr);
+    vkDestroyImage(logicalDevice, momentsImage.image, nullptr);
+    vkFreeMemory(logicalDevice, momentsImage.imageMemory, nullptr);
+}
@@ -0,0 +1,71 @@
+#ifndef REINA_VK_ADAPTIVESAMPLER_H
+#define REINA_VK_ADAPTIVESAMPLER_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+#include "../core/Buffer.h"
+#include "../core/DescriptorSet.h"
+#include "../tools/vktools.h"
+#include "ShaderLoader.h"
+
+namespace reina::graphics {
+    /**
+     * Spends the samples where the image is still noisy, enabled with --adaptive <threshold>. The raygen shader variant
+     * raytrace.adaptive.rgen keeps the mean and second moment of every pixel's luminance, with its own sample count,
+     * in a moments image next to the ray traced image. Before each dispatch but the first after a reset, a compute pass
+     * lists the pixels whose relative standard error is still above the threshold, and the dispatch is an indirect
+     * trace rays call with one invocation per listed pixel. Converged pixels get no more samples, so each dispatch gets
+     * cheaper, and with a frame budget the sample scheduler spends the freed time on more samples for the rest.
+     *
+     * Adds bindings 7 (moments image) and 8 (work list) to the ray tracing descriptor set.
+     */
+    class AdaptiveSampler {
+    public:
+        AdaptiveSampler(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, uint32_t width, uint32_t height, float threshold);
+
+        [[nodiscard]] static std::vector<reina::core::Binding> getBindings();
+        void writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const;
+
+        /**
+         * Moves the moments image into the general layout. Must be recorded before the first dispatch.
+         */
+        void recordInitialization(VkCommandBuffer cmdBuffer) const;
+
+        /**
+         * Fills the work list from the moments of the previous dispatches. Synchronizes with the previous dispatch and
+         * with the indirect trace rays call that follows.
+         */
+        void recordSelection(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet) const;
+
+        /**
+         * Copies the number of listed pixels to host memory, for getListedPixels. Recorded after the trace.
+         */
+        void recordReadback(VkCommandBuffer cmdBuffer) const;
+
+        /**
+         * The length of the last work list, once the command buffer that built it has finished.
+         */
+        [[nodiscard]] uint32_t getListedPixels(VkDevice logicalDevice) const;
+
+        [[nodiscard]] VkDeviceAddress getTraceCommandAddress(VkDevice logicalDevice) const;
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        uint32_t width;
+        uint32_t height;
+        float threshold;
+
+        vktools::ImageObjects momentsImage;
+        VkImageView momentsImageView = VK_NULL_HANDLE;
+        reina::core::Buffer workList;
+        reina::core::Buffer listedPixelsReadback;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline selectPipeline = VK_NULL_HANDLE;
+    };
+}
+
+#endif //REINA_VK_ADAPTIVESAMPLER_H
@@ -0,0 +1,100 @@
+#include "AovImages.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    constexpr uint32_t FIRST_BINDING = 15;
+
+    // in the order of the AOV bits
+    constexpr std::array<std::string_view, AOV_COUNT> AOV_NAMES{"albedo", "normal", "depth", "id", "cost"};
+
+    bool isEnabled(uint32_t enabledAovs, size_t aov) {
+        return (enabledAovs & (1u << aov)) != 0;
+    }
+}
+
+reina::graphics::AovImages::AovImages(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height, uint32_t enabledAovs)
+    : width(width), height(height), enabledAovs(enabledAovs) {
+    for (size_t i = 0; i < images.size(); i++) {
+        images[i] = isEnabled(enabledAovs, i)
+                ? vktools::createRtImage(logicalDevice, physicalDevice, width, height)
+                : vktools::createRtImage(logicalDevice, physicalDevice, 1, 1);
+        imageViews[i] = vktools::createRtImageView(logicalDevice, images[i].image);
+    }
+}
+
+std::vector<reina::core::Binding> reina::graphics::AovImages::getBindings() {
+    // the denoiser's compute passes read the albedo and normal
+    std::vector<reina::core::Binding> bindings;
+    for (uint32_t i = 0; i < AOV_COUNT; i++) {
+        bindings.push_back(reina::core::Binding{FIRST_BINDING + i, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT});
+    }
+
+    return bindings;
+}
+
+void reina::graphics::AovImages::writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const {
+    for (size_t i = 0; i < imageViews.size(); i++) {
+        VkDescriptorImageInfo imageInfo{.imageView = imageViews[i], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+        sceneDescriptorSet.writeBinding(logicalDevice, FIRST_BINDING + static_cast<uint32_t>(i), &imageInfo, nullptr, nullptr, nullptr);
+    }
+}
+
+void reina::graphics::AovImages::recordInitialization(VkCommandBuffer cmdBuffer) const {
+    std::array<VkImageMemoryBarrier, AOV_COUNT> barriers{};
+    for (size_t i = 0; i < images.size(); i++) {
+        barriers[i] = vktools::imageBarrier(images[i].image, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    VkClearColorValue zero{};
+    VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    for (const vktools::ImageObjects& image : images) {
+        vkCmdClearColorImage(cmdBuffer, image.image, VK_IMAGE_LAYOUT_GENERAL, &zero, 1, &range);
+    }
+
+    vktools::memoryBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void reina::graphics::AovImages::write(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const std::string& prefix) const {
+    for (size_t i = 0; i < images.size(); i++) {
+        if (!isEnabled(enabledAovs, i)) {
+            continue;
+        }
+
+        reina::tools::HostImage image = vktools::readRtImage(logicalDevice, physicalDevice, cmdPool, queue, images[i].image, width, height);
+        reina::tools::writePfm(prefix + "." + std::string(AOV_NAMES[i]) + ".pfm", image);
+    }
+}
+
+void reina::graphics::AovImages::destroy(VkDevice logicalDevice) {
+    for (size_t i = 0; i < images.size(); i++) {
+        vkDestroyImageView(logicalDevice, imageViews[i], nullptr);
+        vkDestroyImage(logicalDevice, images[i].image, nullptr);
+        vkFreeMemory(logicalDevice, images[i].imageMemory, nullptr);
+    }
+}
+
+uint32_t reina::graphics::AovImages::parseNames(const std::vector<std::string>& names) {
+    uint32_t enabledAovs = 0;
+    for (const std::string& name : names) {
+        if (name == "all") {
+            enabledAovs |= (1u << AOV_COUNT) - 1;
+            continue;
+        }
+
+        auto it = std::find(AOV_NAMES.begin(), AOV_NAMES.end(), name);
+        if (it == AOV_NAMES.end()) {
+            throw std::runtime_error("Unknown AOV: " + name);
+        }
+
+        enabledAovs |= 1u << (it - AOV_NAMES.begin());
+    }
+
+    return enabledAovs;
+}
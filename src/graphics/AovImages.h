@@ -0,0 +1,65 @@
+#ifndef REINA_VK_AOVIMAGES_H
+#define REINA_VK_AOVIMAGES_H
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "../core/DescriptorSet.h"
+#include "../tools/ImageIO.h"
+#include "../tools/vktools.h"
+#include "../../polyglot/common.h"
+
+namespace reina::graphics {
+    /**
+     * Arbitrary output variables of the camera rays' first hits: albedo, shading normal, linear depth, object,
+     * primitive and instance IDs, and the segments traced per sample as a cost heatmap. The raygen shader writes them
+     * with the first dispatch after each reset, see shaders/aov.h.glsl.
+     *
+     * The enabled AOVs are a bit mask of AOV_ALBEDO etc. (polyglot/common.h), passed to the raygen shader as a
+     * specialization constant, so a disabled AOV costs neither its store nor the work that feeds it. Its binding still
+     * has to be valid, so it gets a 1x1 image.
+     *
+     * The albedo and normal are also the Denoiser's features, so they are enabled whenever it is.
+     *
+     * Adds bindings 15 to 19 to the ray tracing descriptor set.
+     */
+    class AovImages {
+    public:
+        AovImages(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height, uint32_t enabledAovs);
+
+        [[nodiscard]] static std::vector<reina::core::Binding> getBindings();
+        void writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const;
+
+        /**
+         * Moves the images into the general layout and clears them. Must be recorded before the first dispatch.
+         */
+        void recordInitialization(VkCommandBuffer cmdBuffer) const;
+
+        /**
+         * Reads back every enabled AOV and writes it to <prefix>.<name>.pfm, e.g. render.depth.pfm. Waits for the
+         * queue, so only for the end of a headless render.
+         */
+        void write(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const std::string& prefix) const;
+
+        void destroy(VkDevice logicalDevice);
+
+        /**
+         * The bit mask of the AOVs named in --aov: albedo, normal, depth, id, cost or all. Throws on other names.
+         */
+        [[nodiscard]] static uint32_t parseNames(const std::vector<std::string>& names);
+
+    private:
+        uint32_t width;
+        uint32_t height;
+        uint32_t enabledAovs;
+
+        // in binding order, which is the order of the bits
+        std::array<vktools::ImageObjects, AOV_COUNT> images;
+        std::array<VkImageView, AOV_COUNT> imageViews{};
+    };
+}
+
+#endif //REINA_VK_AOVIMAGES_H
@@ -7,16 +7,16 @@
 reina::graphics::Blas::Blas(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue,
                             const reina::graphics::Models& models, const reina::graphics::ModelRange& modelRange) {
 
-    uint32_t vertexCount = static_cast<uint32_t>(models.getVerticesBufferSize()) / 3;
+    auto vertexCount = static_cast<uint32_t>(models.getVertexCount());
 
     VkAccelerationStructureGeometryTrianglesDataKHR triangles{
             .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR,
-            .vertexFormat = VK_FORMAT_R32G32B32_SFLOAT,
-            .vertexData = {.deviceAddress = models.getVerticesBuffer().getDeviceAddress(logicalDevice)},
-            .vertexStride = 4 * sizeof(float),
+            .vertexFormat = models.getBlasVertexFormat(),
+            .vertexData = {.deviceAddress = models.getBlasVerticesBuffer().getDeviceAddress(logicalDevice)},
+            .vertexStride = models.getBlasVertexStride(),
             .maxVertex = vertexCount - 1,
-            .indexType = VK_INDEX_TYPE_UINT32,
-            .indexData = {.deviceAddress = models.getNonOffsetIndicesBuffer().getDeviceAddress(logicalDevice)}
+            .indexType = modelRange.indexType,
+            .indexData = {.deviceAddress = models.getIndicesBuffer().getDeviceAddress(logicalDevice)}
     };
 
     VkAccelerationStructureGeometryKHR geometry{
@@ -33,6 +33,37 @@ reina::graphics::Blas::Blas(VkDevice logicalDevice, VkPhysicalDevice physicalDev
             .transformOffset = 0
     };
 
+    build(logicalDevice, physicalDevice, cmdPool, queue, geometry, buildRangeInfo);
+}
+
+reina::graphics::Blas::Blas(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue,
+                            const reina::core::Buffer& aabbs, uint32_t firstAabb, uint32_t aabbCount) {
+
+    VkAccelerationStructureGeometryAabbsDataKHR aabbsData{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_AABBS_DATA_KHR,
+            .data = {.deviceAddress = aabbs.getDeviceAddress(logicalDevice)},
+            .stride = sizeof(VkAabbPositionsKHR)
+    };
+
+    VkAccelerationStructureGeometryKHR geometry{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+            .geometryType = VK_GEOMETRY_TYPE_AABBS_KHR,
+            .geometry = {.aabbs = aabbsData},
+            .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
+    };
+
+    VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo{
+            .primitiveCount = aabbCount,
+            .primitiveOffset = static_cast<uint32_t>(firstAabb * sizeof(VkAabbPositionsKHR)),
+            .firstVertex = 0,
+            .transformOffset = 0
+    };
+
+    build(logicalDevice, physicalDevice, cmdPool, queue, geometry, buildRangeInfo);
+}
+
+void reina::graphics::Blas::build(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue,
+                                  const VkAccelerationStructureGeometryKHR& geometry, const VkAccelerationStructureBuildRangeInfoKHR& buildRangeInfo) {
     VkAccelerationStructureBuildGeometryInfoKHR buildSizesQueryBuildInfo{
             .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
             .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
@@ -13,6 +13,11 @@ namespace reina::graphics {
     public:
         Blas(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const Models& models, const reina::graphics::ModelRange& modelRange);
 
+        /**
+         * Procedural geometry: one primitive per VkAabbPositionsKHR in aabbs, tested by an intersection shader.
+         */
+        Blas(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const reina::core::Buffer& aabbs, uint32_t firstAabb, uint32_t aabbCount);
+
         [[nodiscard]] VkAccelerationStructureKHR getHandle() const;
         [[nodiscard]] const reina::core::Buffer& getBuffer() const;
 
@@ -20,6 +25,9 @@ namespace reina::graphics {
         void destroy(VkDevice logicalDevice);
 
     private:
+        void build(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue,
+                   const VkAccelerationStructureGeometryKHR& geometry, const VkAccelerationStructureBuildRangeInfoKHR& buildRangeInfo);
+
         std::optional<reina::core::Buffer> blasBuffer;
         VkAccelerationStructureKHR blas = VK_NULL_HANDLE;
     };
@@ -0,0 +1,116 @@
+#include "Denoiser.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "Shader.h"
+#include "../../polyglot/common.h"
+
+namespace {
+    constexpr int OUTPUT_BINDING = 2;
+}
+
+reina::graphics::Denoiser::Denoiser(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, VkImageView outputView, uint32_t width, uint32_t height, uint32_t iterations)
+    : width(width), height(height), iterations(iterations),
+      descriptorSet(logicalDevice, {
+              reina::core::Binding{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT}
+      }) {
+    for (size_t i = 0; i < images.size(); i++) {
+        images[i] = vktools::createRtImage(logicalDevice, physicalDevice, width, height);
+        imageViews[i] = vktools::createRtImageView(logicalDevice, images[i].image);
+
+        VkDescriptorImageInfo imageInfo{.imageView = imageViews[i], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+        descriptorSet.writeBinding(logicalDevice, static_cast<int>(i), &imageInfo, nullptr, nullptr, nullptr);
+    }
+
+    VkDescriptorImageInfo outputInfo{.imageView = outputView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    descriptorSet.writeBinding(logicalDevice, OUTPUT_BINDING, &outputInfo, nullptr, nullptr, nullptr);
+
+    VkDescriptorSetLayout setLayouts[] = {sceneDescriptorSet.getLayout(), descriptorSet.getLayout()};
+    VkPushConstantRange pushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = sizeof(DenoisePushConstantsStruct)
+    };
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 2,
+            .pSetLayouts = setLayouts,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange
+    };
+
+    if (vkCreatePipelineLayout(logicalDevice, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Cannot create denoiser pipeline layout");
+    }
+
+    auto createPipeline = [&](const std::string& shaderName) {
+        Shader shader{logicalDevice, shaderLoader.load(shaderName), VK_SHADER_STAGE_COMPUTE_BIT};
+        VkPipeline pipeline = vktools::createComputePipeline(logicalDevice, pipelineCache, pipelineLayout, shader);
+        shader.destroy(logicalDevice);
+
+        return pipeline;
+    };
+
+    variancePipeline = createPipeline("denoise.variance.comp");
+    atrousPipeline = createPipeline("denoise.atrous.comp");
+}
+
+void reina::graphics::Denoiser::recordInitialization(VkCommandBuffer cmdBuffer) const {
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    for (size_t i = 0; i < images.size(); i++) {
+        barriers[i] = vktools::imageBarrier(images[i].image, 0, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+}
+
+void reina::graphics::Denoiser::record(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet) {
+    // the dispatch wrote the image and the features, the previous frame's tone mapper read the output
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    sceneDescriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0);
+    descriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 1);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, variancePipeline);
+    dispatchImage(cmdBuffer);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, atrousPipeline);
+    for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+        vktools::memoryBarrier(cmdBuffer,
+                               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        DenoisePushConstantsStruct pushConstants{1u << iteration, iteration % 2, iteration + 1 == iterations ? 1u : 0u};
+        vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+        dispatchImage(cmdBuffer);
+    }
+
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+void reina::graphics::Denoiser::dispatchImage(VkCommandBuffer cmdBuffer) const {
+    vkCmdDispatch(cmdBuffer, (width + DENOISE_WORKGROUP_SIZE - 1) / DENOISE_WORKGROUP_SIZE, (height + DENOISE_WORKGROUP_SIZE - 1) / DENOISE_WORKGROUP_SIZE, 1);
+}
+
+void reina::graphics::Denoiser::destroy(VkDevice logicalDevice) {
+    vkDestroyPipeline(logicalDevice, variancePipeline, nullptr);
+    vkDestroyPipeline(logicalDevice, atrousPipeline, nullptr);
+    vkDestroyPipelineLayout(logicalDevice, pipelineLayout, nullptr);
+
+    descriptorSet.destroy(logicalDevice);
+    for (size_t i = 0; i < images.size(); i++) {
+        vkDestroyImageView(logicalDevice, imageViews[i], nullptr);
+        vkDestroyImage(logicalDevice, images[i].image, nullptr);
+        vkFreeMemory(logicalDevice, images[i].imageMemory, nullptr);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef REINA_VK_DENOISER_H
+#define REINA_VK_DENOISER_H
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+
+#include "../core/DescriptorSet.h"
+#include "../tools/vktools.h"
+#include "ShaderLoader.h"
+
+namespace reina::graphics {
+    /**
+     * Filters the accumulated image for display, enabled with --denoise <iterations>. SVGF style compute passes:
+     *  - variance: the variance of each pixel's mean luminance, from the luminance moments the raygen shader keeps
+     *    over all of the pixel's samples (temporally, through reprojection). Short histories borrow their neighbours'
+     *    moments
+     *  - a-trous: iterations of an edge-avoiding wavelet filter with doubling step sizes, which stop at differences in
+     *    depth, normal and albedo, and at luminance differences the variance doesn't explain
+     * The variance of the mean shrinks with the sample count, so the filter blurs a lot at 1 to 4 spp and fades out as
+     * the image converges. The accumulation image itself stays unfiltered, the result goes to the display image of the
+     * Accumulator, in place of its resolve pass.
+     *
+     * Reads the positions and moments of TemporalHistory and the albedo and normal of AovImages, through the ray
+     * tracing descriptor set as set 0.
+     */
+    class Denoiser {
+    public:
+        Denoiser(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, VkImageView outputView, uint32_t width, uint32_t height, uint32_t iterations);
+
+        /**
+         * Moves the images into the general layout. Must be recorded before the first record.
+         */
+        void recordInitialization(VkCommandBuffer cmdBuffer) const;
+
+        /**
+         * Records the passes after a dispatch of the raygen shader, and synchronizes the output with the tone mapper.
+         */
+        void record(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet);
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        uint32_t width;
+        uint32_t height;
+        uint32_t iterations;
+
+        std::array<vktools::ImageObjects, 2> images;
+        std::array<VkImageView, 2> imageViews{};
+        reina::core::DescriptorSet descriptorSet;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline variancePipeline = VK_NULL_HANDLE;
+        VkPipeline atrousPipeline = VK_NULL_HANDLE;
+
+        void dispatchImage(VkCommandBuffer cmdBuffer) const;
+    };
+}
+
+#endif //REINA_VK_DENOISER_H
@@ -0,0 +1,27 @@
+#ifndef REINA_VK_EMBEDDEDSHADERS_H
+#define REINA_VK_EMBEDDEDSHADERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace reina::graphics {
+    /**
+     * A shader variant compiled to SPIR-V at build time. The list of variants lives in CMakeLists.txt, which also
+     * generates the definition of getEmbeddedShaders. Source, stage and defines are kept so ShaderLoader can compile
+     * the same variant from GLSL at runtime.
+     */
+    struct EmbeddedShader {
+        std::string_view name;     // e.g. lambertian.sphere.rchit
+        std::string_view stage;    // as passed to glslc -fshader-stage
+        std::string_view source;   // relative to the shaders directory
+        std::string_view defines;  // space separated, each passed as -D
+        const uint32_t* code;
+        size_t wordCount;
+    };
+
+    [[nodiscard]] std::span<const EmbeddedShader> getEmbeddedShaders();
+}
+
+#endif //REINA_VK_EMBEDDEDSHADERS_H
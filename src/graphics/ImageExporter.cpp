@@ -0,0 +1,401 @@
+#include "ImageExporter.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "../tools/ImageIO.h"
+#include "../../polyglot/common.h"
+
+namespace {
+    constexpr size_t BYTES_PER_PIXEL = 4 * sizeof(float);  // the accumulation image is RGBA32F
+
+    // host cached memory makes the worker's reads from the staging buffer as fast as from any allocation, while
+    // uncached host memory is read at a fraction of that. few drivers lack it, they get coherent memory instead
+    VkMemoryPropertyFlags getStagingMemoryFlags(VkPhysicalDevice physicalDevice) {
+        VkPhysicalDeviceMemoryProperties memProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+        constexpr VkMemoryPropertyFlags cached = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+            if ((memProperties.memoryTypes[i].propertyFlags & cached) == cached) {
+                return cached;
+            }
+        }
+
+        return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
+
+    VkSemaphore createTimeline(VkDevice logicalDevice) {
+        VkSemaphoreTypeCreateInfo typeInfo{
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+                .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+                .initialValue = 0
+        };
+        VkSemaphoreCreateInfo semaphoreInfo{
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+                .pNext = &typeInfo
+        };
+
+        VkSemaphore timeline;
+        if (vkCreateSemaphore(logicalDevice, &semaphoreInfo, nullptr, &timeline) != VK_SUCCESS) {
+            throw std::runtime_error("Cannot create export timeline semaphore");
+        }
+
+        return timeline;
+    }
+
+    VkBufferMemoryBarrier ownershipBarrier(VkBuffer buffer, VkAccessFlags srcAccess, VkAccessFlags dstAccess, uint32_t srcFamily, uint32_t dstFamily) {
+        return VkBufferMemoryBarrier{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                .srcAccessMask = srcAccess,
+                .dstAccessMask = dstAccess,
+                .srcQueueFamilyIndex = srcFamily,
+                .dstQueueFamilyIndex = dstFamily,
+                .buffer = buffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE
+        };
+    }
+}
+
+reina::graphics::ImageExporter::ImageExporter(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t graphicsFamily, uint32_t transferFamily, VkQueue transferQueue, VkImage accumulationImage, VkImage compensationImage, VkBuffer exposureBuffer, uint32_t width, uint32_t height)
+    : logicalDevice(logicalDevice), graphicsFamily(graphicsFamily), transferFamily(transferFamily), transferQueue(transferQueue),
+      accumulationImage(accumulationImage), compensationImage(compensationImage), exposureBuffer(exposureBuffer), width(width), height(height) {
+    readyTimeline = createTimeline(logicalDevice);
+
+    if (hasDedicatedTransfer()) {
+        snapshotTimeline = createTimeline(logicalDevice);
+
+        VkCommandPoolCreateInfo poolInfo{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .queueFamilyIndex = transferFamily
+        };
+
+        if (vkCreateCommandPool(logicalDevice, &poolInfo, nullptr, &transferPool) != VK_SUCCESS) {
+            throw std::runtime_error("Cannot create export command pool");
+        }
+    }
+
+    const VkMemoryPropertyFlags stagingFlags = getStagingMemoryFlags(physicalDevice);
+    for (size_t i = 0; i < RING_SIZE; i++) {
+        Slot slot{
+                .staging = reina::core::Buffer(logicalDevice, physicalDevice, getStagingSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, stagingFlags)
+        };
+
+        void* mapped;
+        if (vkMapMemory(logicalDevice, slot.staging.getDeviceMemory(), 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("Cannot map export staging buffer");
+        }
+        slot.mapped = mapped;
+
+        if (hasDedicatedTransfer()) {
+            slot.snapshot.emplace(logicalDevice, physicalDevice, getStagingSize(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+            VkCommandBufferAllocateInfo allocInfo{
+                    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                    .commandPool = transferPool,
+                    .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                    .commandBufferCount = 1
+            };
+
+            if (vkAllocateCommandBuffers(logicalDevice, &allocInfo, &slot.transferCommands) != VK_SUCCESS) {
+                throw std::runtime_error("Cannot allocate export command buffer");
+            }
+
+            recordTransferCommands(slot);
+        }
+
+        slots.push_back(std::move(slot));
+    }
+
+    // started last, once everything they read is initialized
+    for (size_t i = 0; i < WORKER_COUNT; i++) {
+        workers.emplace_back(&ImageExporter::run, this);
+    }
+}
+
+bool reina::graphics::ImageExporter::recordCapture(VkCommandBuffer cmdBuffer, const std::string& filepath) {
+    if (recorded.has_value()) {
+        return false;  // one capture per frame
+    }
+
+    std::optional<size_t> freeSlot;
+    {
+        std::lock_guard lock(mutex);
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (!slots[i].busy) {
+                slots[i].busy = true;
+                freeSlot = i;
+                break;
+            }
+        }
+    }
+
+    if (!freeSlot.has_value()) {
+        return false;
+    }
+
+    Slot& slot = slots[freeSlot.value()];
+    VkBuffer destination = hasDedicatedTransfer() ? slot.snapshot->getHandle() : slot.staging.getHandle();
+
+    // the dispatch, the resolve and the denoiser are done with the sums, the previous frame's exposure pass with the
+    // adapted luminance
+    VkMemoryBarrier writtenBarrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT
+    };
+    vkCmdPipelineBarrier(cmdBuffer,
+                         VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &writtenBarrier, 0, nullptr, 0, nullptr);
+
+    VkBufferImageCopy region{
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {width, height, 1}
+    };
+    vkCmdCopyImageToBuffer(cmdBuffer, accumulationImage, VK_IMAGE_LAYOUT_GENERAL, destination, 1, &region);
+
+    if (COMPENSATED_ACCUMULATION) {
+        region.bufferOffset = getImageSize();
+        vkCmdCopyImageToBuffer(cmdBuffer, compensationImage, VK_IMAGE_LAYOUT_GENERAL, destination, 1, &region);
+    }
+
+    // the exposure this frame's tone mapper applies
+    if (exposureBuffer != VK_NULL_HANDLE) {
+        VkBufferCopy exposureRegion{.srcOffset = 0, .dstOffset = getExposureOffset(), .size = sizeof(float)};
+        vkCmdCopyBuffer(cmdBuffer, exposureBuffer, destination, 1, &exposureRegion);
+    }
+
+    // the snapshot is released to the transfer queue, the staging buffer made visible to the worker. either way, the
+    // next frame's passes only overwrite the sums after the copy
+    if (hasDedicatedTransfer()) {
+        VkBufferMemoryBarrier release = ownershipBarrier(destination, VK_ACCESS_TRANSFER_WRITE_BIT, 0, graphicsFamily, transferFamily);
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, 1, &release, 0, nullptr);
+
+        snapshotValue++;
+    } else {
+        VkMemoryBarrier hostBarrier{
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    recorded = Job{freeSlot.value(), ++readyValue, filepath};
+    return true;
+}
+
+std::optional<reina::graphics::ImageExporter::TimelineSignal> reina::graphics::ImageExporter::getFrameSignal() const {
+    if (!recorded.has_value()) {
+        return std::nullopt;
+    }
+
+    // with a dedicated transfer queue, the transfer submission signals the ready timeline once it has waited for this
+    if (hasDedicatedTransfer()) {
+        return TimelineSignal{snapshotTimeline, snapshotValue};
+    }
+
+    return TimelineSignal{readyTimeline, recorded->readyValue};
+}
+
+void reina::graphics::ImageExporter::submit() {
+    if (!recorded.has_value()) {
+        return;
+    }
+
+    if (hasDedicatedTransfer()) {
+        const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        VkTimelineSemaphoreSubmitInfo timelineInfo{
+                .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+                .waitSemaphoreValueCount = 1,
+                .pWaitSemaphoreValues = &snapshotValue,
+                .signalSemaphoreValueCount = 1,
+                .pSignalSemaphoreValues = &recorded->readyValue
+        };
+        VkSubmitInfo submitInfo{
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                .pNext = &timelineInfo,
+                .waitSemaphoreCount = 1,
+                .pWaitSemaphores = &snapshotTimeline,
+                .pWaitDstStageMask = &waitStage,
+                .commandBufferCount = 1,
+                .pCommandBuffers = &slots[recorded->slot].transferCommands,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores = &readyTimeline
+        };
+
+        if (vkQueueSubmit(transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("Could not submit export copy");
+        }
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        jobs.push_back(std::move(recorded.value()));
+    }
+
+    recorded.reset();
+    jobCondition.notify_one();
+}
+
+void reina::graphics::ImageExporter::destroy(VkDevice logicalDevice) {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+
+    jobCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (Slot& slot : slots) {
+        vkUnmapMemory(logicalDevice, slot.staging.getDeviceMemory());
+        slot.staging.destroy(logicalDevice);
+        if (slot.snapshot.has_value()) {
+            slot.snapshot->destroy(logicalDevice);
+        }
+    }
+
+    if (transferPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(logicalDevice, transferPool, nullptr);
+    }
+    if (snapshotTimeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(logicalDevice, snapshotTimeline, nullptr);
+    }
+    vkDestroySemaphore(logicalDevice, readyTimeline, nullptr);
+}
+
+bool reina::graphics::ImageExporter::hasDedicatedTransfer() const {
+    return transferFamily != graphicsFamily;
+}
+
+VkDeviceSize reina::graphics::ImageExporter::getImageSize() const {
+    return static_cast<VkDeviceSize>(width) * height * BYTES_PER_PIXEL;
+}
+
+VkDeviceSize reina::graphics::ImageExporter::getExposureOffset() const {
+    return COMPENSATED_ACCUMULATION ? 2 * getImageSize() : getImageSize();
+}
+
+VkDeviceSize reina::graphics::ImageExporter::getStagingSize() const {
+    return getExposureOffset() + (exposureBuffer != VK_NULL_HANDLE ? sizeof(float) : 0);
+}
+
+void reina::graphics::ImageExporter::recordTransferCommands(Slot& slot) const {
+    // the same copy every time, so it is recorded once
+    VkCommandBufferBeginInfo beginInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    if (vkBeginCommandBuffer(slot.transferCommands, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Could not begin export command buffer");
+    }
+
+    VkBufferMemoryBarrier acquire = ownershipBarrier(slot.snapshot->getHandle(), 0, VK_ACCESS_TRANSFER_READ_BIT, graphicsFamily, transferFamily);
+    vkCmdPipelineBarrier(slot.transferCommands, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 1, &acquire, 0, nullptr);
+
+    VkBufferCopy region{.srcOffset = 0, .dstOffset = 0, .size = getStagingSize()};
+    vkCmdCopyBuffer(slot.transferCommands, slot.snapshot->getHandle(), slot.staging.getHandle(), 1, &region);
+
+    VkMemoryBarrier hostBarrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+    };
+    vkCmdPipelineBarrier(slot.transferCommands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+
+    if (vkEndCommandBuffer(slot.transferCommands) != VK_SUCCESS) {
+        throw std::runtime_error("Could not end export command buffer");
+    }
+}
+
+void reina::graphics::ImageExporter::run() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        jobCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            return;  // stopping, and every capture in flight is written
+        }
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+
+        lock.unlock();
+        finish(job);
+        lock.lock();
+    }
+}
+
+void reina::graphics::ImageExporter::finish(const Job& job) {
+    const Slot& slot = slots[job.slot];
+
+    VkSemaphoreWaitInfo waitInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &readyTimeline,
+            .pValues = &job.readyValue
+    };
+    VkResult waitResult = vkWaitSemaphores(logicalDevice, &waitInfo, UINT64_MAX);
+
+    reina::tools::HostImage image{width, height, {}};
+    reina::tools::HostImage compensation{width, height, {}};
+    float exposure = 1.0f;
+    if (waitResult == VK_SUCCESS) {
+        // a no-op for coherent memory
+        VkMappedMemoryRange range{
+                .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+                .memory = slot.staging.getDeviceMemory(),
+                .offset = 0,
+                .size = VK_WHOLE_SIZE
+        };
+        vkInvalidateMappedMemoryRanges(logicalDevice, 1, &range);
+
+        const auto* staging = static_cast<const std::byte*>(slot.mapped);
+        image.pixels.resize(static_cast<size_t>(width) * height * 4);
+        std::memcpy(image.pixels.data(), staging, getImageSize());
+
+        if (COMPENSATED_ACCUMULATION) {
+            compensation.pixels.resize(image.pixels.size());
+            std::memcpy(compensation.pixels.data(), staging + getImageSize(), getImageSize());
+        }
+
+        if (exposureBuffer != VK_NULL_HANDLE) {
+            float adaptedLuminance;
+            std::memcpy(&adaptedLuminance, staging + getExposureOffset(), sizeof(float));
+
+            // as in tonemap.apply.comp.glsl
+            exposure = adaptedLuminance > 0.0f ? static_cast<float>(TONEMAP_KEY) / adaptedLuminance : 1.0f;
+        }
+    }
+
+    // the slot is free again before the slow part
+    {
+        std::lock_guard lock(mutex);
+        slots[job.slot].busy = false;
+    }
+
+    if (waitResult != VK_SUCCESS) {
+        std::cerr << "Export of " << job.filepath << " failed: could not wait for the copy\n";
+        return;
+    }
+
+    try {
+        reina::tools::resolveAccumulation(image, COMPENSATED_ACCUMULATION ? &compensation : nullptr);
+        reina::tools::writeImage(job.filepath, image, exposure);
+        std::cout << "Exported " << job.filepath << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Export of " << job.filepath << " failed: " << e.what() << "\n";
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef REINA_VK_IMAGEEXPORTER_H
+#define REINA_VK_IMAGEEXPORTER_H
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../core/Buffer.h"
+
+namespace reina::graphics {
+    /**
+     * Screenshots and frame export without stalling the render loop. A capture copies the accumulation image into one
+     * of a ring of persistently mapped, host cached staging buffers, and a worker thread waits for the copy, resolves
+     * the sums to means and encodes the file (PNG, EXR or PFM by extension, see ImageIO.h). The render loop only pays
+     * for the copy: nothing waits on the GPU, and when every slot is still busy the capture is dropped instead.
+     *
+     * The Kahan compensation (COMPENSATED_ACCUMULATION) is copied along, so the means are the same as the resolve
+     * pass's. So is the tone mapper's adapted luminance when there is one, which exposes PNGs like the window.
+     *
+     * With a dedicated transfer queue family, the frame's command buffer only copies the image into a device local
+     * snapshot at VRAM speed, and the transfer queue moves it over PCIe while the next frames render. Without one, the
+     * frame copies straight into the staging buffer. The workers wait on the ready timeline, which only the queue that
+     * fills the staging buffer signals: the transfer queue, after waiting for the frame on the snapshot timeline, or
+     * else the frame's submission itself.
+     */
+    class ImageExporter {
+    public:
+        /**
+         * @param compensationImage the accumulator's, only read with COMPENSATED_ACCUMULATION
+         * @param exposureBuffer the tone mapper's, VK_NULL_HANDLE without one, for a fixed exposure of 1
+         */
+        ImageExporter(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t graphicsFamily, uint32_t transferFamily, VkQueue transferQueue, VkImage accumulationImage, VkImage compensationImage, VkBuffer exposureBuffer, uint32_t width, uint32_t height);
+
+        /**
+         * Records the copy of the accumulation image into a free slot at the end of a frame, after the passes that
+         * write it and before the tone mapper. The images must be in the general layout. Returns false, recording
+         * nothing, if every slot is busy.
+         */
+        bool recordCapture(VkCommandBuffer cmdBuffer, const std::string& filepath);
+
+        struct TimelineSignal {
+            VkSemaphore semaphore;
+            uint64_t value;
+        };
+
+        /**
+         * What the frame's submission must signal, if recordCapture recorded a copy into it.
+         */
+        [[nodiscard]] std::optional<TimelineSignal> getFrameSignal() const;
+
+        /**
+         * Hands the recorded capture on to the transfer queue and the workers. Must be called after the frame's
+         * submission, even if nothing was recorded.
+         */
+        void submit();
+
+        /**
+         * Finishes the captures in flight, then stops and joins the workers.
+         */
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        static constexpr size_t RING_SIZE = 3;
+        static constexpr size_t WORKER_COUNT = 2;  // encoding PNGs is the slow part, the copies out of a slot are quick
+
+        struct Slot {
+            reina::core::Buffer staging;  // the sums, the compensation and the adapted luminance
+            std::optional<reina::core::Buffer> snapshot;  // only with a dedicated transfer queue
+            VkCommandBuffer transferCommands = VK_NULL_HANDLE;
+            const void* mapped = nullptr;
+            bool busy = false;
+        };
+
+        struct Job {
+            size_t slot;
+            uint64_t readyValue;
+            std::string filepath;
+        };
+
+        VkDevice logicalDevice;
+        uint32_t graphicsFamily;
+        uint32_t transferFamily;
+        VkQueue transferQueue;
+        VkImage accumulationImage;
+        VkImage compensationImage;
+        VkBuffer exposureBuffer;
+        uint32_t width;
+        uint32_t height;
+
+        std::vector<Slot> slots;
+        VkCommandPool transferPool = VK_NULL_HANDLE;
+
+        // each timeline is signalled by a single queue, so its values increase in submission order
+        VkSemaphore snapshotTimeline = VK_NULL_HANDLE;  // graphics to transfer, only with a dedicated transfer queue
+        uint64_t snapshotValue = 0;
+        VkSemaphore readyTimeline = VK_NULL_HANDLE;  // the staging buffer is filled, waited on by the workers
+        uint64_t readyValue = 0;
+
+        std::optional<Job> recorded;
+
+        std::mutex mutex;
+        std::condition_variable jobCondition;
+        std::deque<Job> jobs;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+
+        [[nodiscard]] bool hasDedicatedTransfer() const;
+        [[nodiscard]] VkDeviceSize getImageSize() const;
+        [[nodiscard]] VkDeviceSize getExposureOffset() const;  // after the sums and the compensation
+        [[nodiscard]] VkDeviceSize getStagingSize() const;
+        void recordTransferCommands(Slot& slot) const;
+        void run();
+        void finish(const Job& job);
+    };
+}
+
+#endif //REINA_VK_IMAGEEXPORTER_H
@@ -3,11 +3,12 @@
 
 #include "Blas.h"
 
+#include <memory>
 #include <glm/mat4x4.hpp>
 
 namespace reina::graphics {
     struct Instance {
-        const Blas& blas;
+        std::shared_ptr<const Blas> blas;  // shared by every instance of the same mesh, see MeshRegistry
         uint32_t objectPropertiesID = 0;
         uint32_t materialOffset = 0;
         glm::mat4x4 transform = glm::mat4x4(1.0f);
@@ -0,0 +1,185 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <unordered_map>
+
+namespace {
+    constexpr size_t FLOATS_PER_VERTEX = 9;  // position with w, normal, UV
+    constexpr size_t CACHE_LINE_SIZE = 64;
+    constexpr size_t SIMULATED_CACHE_LINES = 512;  // 32 KiB, about an L1
+
+    using VertexBits = std::array<uint32_t, FLOATS_PER_VERTEX>;
+
+    struct VertexBitsHash {
+        size_t operator()(const VertexBits& bits) const {
+            size_t hash = 0;
+            for (uint32_t word : bits) {
+                hash = hash * 31 + word;
+            }
+
+            return hash;
+        }
+    };
+
+    VertexBits getVertexBits(const reina::graphics::MeshArrays& arrays, size_t vertex) {
+        VertexBits bits;
+        std::memcpy(bits.data(), arrays.vertices.data() + vertex * 4, 4 * sizeof(float));
+        std::memcpy(bits.data() + 4, arrays.normals.data() + vertex * 3, 3 * sizeof(float));
+        std::memcpy(bits.data() + 7, arrays.uvs.data() + vertex * 2, 2 * sizeof(float));
+        return bits;
+    }
+
+    // spreads the lower 10 bits so there are two zero bits between each
+    uint32_t expandBits(uint32_t value) {
+        value &= 0x3ff;
+        value = (value | (value << 16)) & 0x030000ff;
+        value = (value | (value << 8)) & 0x0300f00f;
+        value = (value | (value << 4)) & 0x030c30c3;
+        value = (value | (value << 2)) & 0x09249249;
+        return value;
+    }
+
+    uint32_t mortonCode(const float* point, const float* boundsMin, const float* boundsSize) {
+        uint32_t code = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            float normalized = boundsSize[axis] > 0 ? (point[axis] - boundsMin[axis]) / boundsSize[axis] : 0.0f;
+            auto cell = static_cast<uint32_t>(std::clamp(normalized * 1024.0f, 0.0f, 1023.0f));
+            code |= expandBits(cell) << (2 - axis);
+        }
+
+        return code;
+    }
+}
+
+void reina::graphics::optimizeMesh(MeshArrays& arrays, ObjRange& range) {
+    size_t firstVertex = range.firstVertex;
+    size_t vertexCount = range.vertexCount;
+    uint32_t* indices = arrays.indices.data() + range.firstIndex;
+
+    // weld vertices that only differ in which OBJ elements they came from
+    std::vector<uint32_t> weldedTo(vertexCount);
+    std::unordered_map<VertexBits, uint32_t, VertexBitsHash> uniqueVertices;
+    uniqueVertices.reserve(vertexCount);
+
+    for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+        weldedTo[vertex] = uniqueVertices.try_emplace(getVertexBits(arrays, firstVertex + vertex), vertex).first->second;
+    }
+
+    for (size_t i = 0; i < range.indexCount; i++) {
+        indices[i] = weldedTo[indices[i]];
+    }
+
+    // sort the triangles of each shape by the Morton code of their centroid, relative to the whole mesh's bounds
+    float boundsMin[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float boundsMax[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    for (size_t vertex = firstVertex; vertex < firstVertex + vertexCount; vertex++) {
+        for (int axis = 0; axis < 3; axis++) {
+            boundsMin[axis] = std::min(boundsMin[axis], arrays.vertices[vertex * 4 + axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], arrays.vertices[vertex * 4 + axis]);
+        }
+    }
+
+    float boundsSize[3] = {boundsMax[0] - boundsMin[0], boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2]};
+
+    std::vector<std::pair<uint32_t, uint32_t>> sortKeys;  // Morton code, triangle within the shape
+    std::vector<uint32_t> sortedIndices;
+
+    for (const ObjShape& shape : range.shapes) {
+        uint32_t* shapeIndices = arrays.indices.data() + shape.firstIndex;
+        size_t triangleCount = shape.indexCount / 3;
+
+        sortKeys.resize(triangleCount);
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            float centroid[3] = {0, 0, 0};
+            for (int corner = 0; corner < 3; corner++) {
+                const float* position = arrays.vertices.data() + (firstVertex + shapeIndices[triangle * 3 + corner]) * 4;
+                for (int axis = 0; axis < 3; axis++) {
+                    centroid[axis] += position[axis] / 3.0f;
+                }
+            }
+
+            sortKeys[triangle] = {mortonCode(centroid, boundsMin, boundsSize), triangle};
+        }
+
+        // the triangle index as tie breaker keeps the result deterministic, so content hashes of equal files match
+        std::sort(sortKeys.begin(), sortKeys.end());
+
+        sortedIndices.resize(shape.indexCount);
+        for (size_t i = 0; i < triangleCount; i++) {
+            std::copy_n(shapeIndices + sortKeys[i].second * 3, 3, sortedIndices.data() + i * 3);
+        }
+
+        std::copy(sortedIndices.begin(), sortedIndices.end(), shapeIndices);
+    }
+
+    // renumber in first use order. welded and unreferenced vertices are left out
+    constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> newIndex(vertexCount, UNUSED);
+    std::vector<uint32_t> oldVertex;
+    oldVertex.reserve(vertexCount);
+
+    for (size_t i = 0; i < range.indexCount; i++) {
+        uint32_t& mapped = newIndex[indices[i]];
+        if (mapped == UNUSED) {
+            mapped = static_cast<uint32_t>(oldVertex.size());
+            oldVertex.push_back(indices[i]);
+        }
+
+        indices[i] = mapped;
+    }
+
+    std::vector<float> vertices(oldVertex.size() * 4);
+    std::vector<float> normals(oldVertex.size() * 3);
+    std::vector<float> uvs(oldVertex.size() * 2);
+
+    for (size_t vertex = 0; vertex < oldVertex.size(); vertex++) {
+        size_t source = firstVertex + oldVertex[vertex];
+        std::copy_n(arrays.vertices.data() + source * 4, 4, vertices.data() + vertex * 4);
+        std::copy_n(arrays.normals.data() + source * 3, 3, normals.data() + vertex * 3);
+        std::copy_n(arrays.uvs.data() + source * 2, 2, uvs.data() + vertex * 2);
+    }
+
+    arrays.vertices.resize(firstVertex * 4);
+    arrays.normals.resize(firstVertex * 3);
+    arrays.uvs.resize(firstVertex * 2);
+    arrays.vertices.insert(arrays.vertices.end(), vertices.begin(), vertices.end());
+    arrays.normals.insert(arrays.normals.end(), normals.begin(), normals.end());
+    arrays.uvs.insert(arrays.uvs.end(), uvs.begin(), uvs.end());
+
+    range.vertexCount = oldVertex.size();
+}
+
+double reina::graphics::simulateVertexFetchMisses(const std::vector<uint32_t>& indices, size_t vertexStride) {
+    if (indices.size() < 3) {
+        return 0;
+    }
+
+    std::list<uint64_t> lines;  // most recently used first
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> cached;
+    size_t misses = 0;
+
+    for (uint32_t index : indices) {
+        uint64_t line = static_cast<uint64_t>(index) * vertexStride / CACHE_LINE_SIZE;
+
+        auto it = cached.find(line);
+        if (it != cached.end()) {
+            lines.splice(lines.begin(), lines, it->second);
+            continue;
+        }
+
+        misses++;
+        lines.push_front(line);
+        cached[line] = lines.begin();
+
+        if (lines.size() > SIMULATED_CACHE_LINES) {
+            cached.erase(lines.back());
+            lines.pop_back();
+        }
+    }
+
+    return static_cast<double>(misses) / static_cast<double>(indices.size() / 3);
+}
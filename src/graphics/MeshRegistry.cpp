@@ -0,0 +1,42 @@
+#include "MeshRegistry.h"
+
+#include <chrono>
+
+reina::graphics::MeshRegistry::MeshRegistry(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const Models& models)
+        : logicalDevice(logicalDevice), physicalDevice(physicalDevice), cmdPool(cmdPool), queue(queue), models(models) {}
+
+reina::graphics::SharedMesh reina::graphics::MeshRegistry::acquire(int modelIndex, int shapeIndex) {
+    ModelRange range = shapeIndex < 0 ? models.getModelRange(modelIndex) : models.getShapeRanges(modelIndex).at(shapeIndex).range;
+    std::weak_ptr<const Blas>& cached = blases[{models.getContentHash(modelIndex), shapeIndex}];
+
+    std::shared_ptr<const Blas> blas = cached.lock();
+    if (!blas) {
+        auto buildStart = std::chrono::steady_clock::now();
+        VkDevice device = logicalDevice;
+        blas = std::shared_ptr<Blas>(
+                new Blas{logicalDevice, physicalDevice, cmdPool, queue, models, range},
+                [device](Blas* expired) {
+                    expired->destroy(device);
+                    delete expired;
+                }
+        );
+
+        cached = blas;
+        buildSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
+    }
+
+    return {range, blas};
+}
+
+double reina::graphics::MeshRegistry::getBuildTime() const {
+    return buildSeconds;
+}
+
+size_t reina::graphics::MeshRegistry::getBlasCount() const {
+    size_t count = 0;
+    for (const auto& [hash, blas] : blases) {
+        count += !blas.expired();
+    }
+
+    return count;
+}
@@ -0,0 +1,47 @@
+#ifndef REINA_VK_MESHREGISTRY_H
+#define REINA_VK_MESHREGISTRY_H
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <map>
+#include <utility>
+
+#include "Models.h"
+#include "Blas.h"
+
+namespace reina::graphics {
+    struct SharedMesh {
+        ModelRange range;
+        std::shared_ptr<const Blas> blas;
+    };
+
+    /**
+     * Hands out one BLAS per unique mesh, keyed by the content hash from Models, so any number of instances of the same
+     * geometry share a single acceleration structure. The registry only holds weak references: a BLAS is destroyed as
+     * soon as the last instance using it is, which must happen before the logical device is destroyed.
+     */
+    class MeshRegistry {
+    public:
+        MeshRegistry(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const Models& models);
+
+        /**
+         * @param shapeIndex a single shape of the model (see Models::getShapeRanges), or -1 for all of them
+         */
+        [[nodiscard]] SharedMesh acquire(int modelIndex, int shapeIndex = -1);
+        [[nodiscard]] size_t getBlasCount() const;  // live BLASes, after deduplication
+        [[nodiscard]] double getBuildTime() const;  // in seconds, of all BLAS builds so far, including the queue waits
+
+    private:
+        VkDevice logicalDevice;
+        VkPhysicalDevice physicalDevice;
+        VkCommandPool cmdPool;
+        VkQueue queue;
+        const Models& models;
+
+        std::map<std::pair<uint64_t, int>, std::weak_ptr<const Blas>> blases;  // by content hash and shape index
+        double buildSeconds = 0;
+    };
+}
+
+#endif //REINA_VK_MESHREGISTRY_H
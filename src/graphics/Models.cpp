@@ -1,148 +1,373 @@
 #include "Models.h"
+#include "VertexCompression.h"
+#include "MeshOptimizer.h"
+#include "../../polyglot/common.h"
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
 #include <stdexcept>
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <glm/packing.hpp>
 
-reina::graphics::Models::Models(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::vector<std::string>& modelFilepaths) {
-    modelRanges = std::vector<ModelRange>(modelFilepaths.size());
-    std::vector<ObjData> allObjectsData(modelFilepaths.size());
-    size_t totalVertices = 0;
-    size_t totalIndices = 0;
+reina::graphics::Models::Models(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::vector<std::string>& modelFilepaths, bool optimizeMeshes) {
+    modelIndices = std::vector<size_t>(modelFilepaths.size());
+
+    // identical geometry is only stored once, whether it's the same file listed twice or different files with the same
+    // payload. a duplicate is parsed into the combined arrays like any other file and then dropped again
+    MeshArrays arrays;
+    std::unordered_map<std::string, size_t> pathToUnique;
+    std::unordered_map<uint64_t, size_t> hashToUnique;
 
     for (int i = 0; i < modelFilepaths.size(); i++) {
-        allObjectsData[i] = getObjData(modelFilepaths[i]);
+        auto pathIt = pathToUnique.find(modelFilepaths[i]);
+        if (pathIt != pathToUnique.end()) {
+            modelIndices[i] = pathIt->second;
+            continue;
+        }
+
+        ModelInfo model = appendObj(modelFilepaths[i], arrays, optimizeMeshes);
+        model.contentHash = hashModel(arrays, model);
+
+        auto [hashIt, inserted] = hashToUnique.try_emplace(model.contentHash, models.size());
+        if (inserted) {
+            models.push_back(std::move(model));
+        } else {
+            if (!sameGeometry(arrays, models[hashIt->second], model)) {
+                throw std::runtime_error("Mesh content hash collision between " + modelFilepaths[i] + " and an earlier model");
+            }
+
+            size_t firstVertex = model.range.firstVertex;
+            size_t firstIndex = model.range.indexOffset / sizeof(uint32_t);
+            arrays.vertices.resize(firstVertex * 4);
+            arrays.normals.resize(firstVertex * 3);
+            arrays.uvs.resize(firstVertex * 2);
+            arrays.indices.resize(firstIndex);
+        }
 
-        totalVertices += allObjectsData[i].vertices.size();
-        totalIndices += allObjectsData[i].indices.size();
+        pathToUnique.emplace(modelFilepaths[i], hashIt->second);
+        modelIndices[i] = hashIt->second;
     }
 
-    std::vector<float> allVertices(totalVertices);
-    std::vector<uint32_t> allIndicesOffset(totalIndices);
-    std::vector<uint32_t> allIndicesNonOffset(totalIndices);
+    // the fetch pattern of the hit shaders, which add firstVertex to the model-local indices
+    std::vector<uint32_t> allIndicesOffset(arrays.indices.size());
+    for (const ModelInfo& model : models) {
+        size_t firstIndex = model.range.indexOffset / sizeof(uint32_t);
+        for (size_t index = firstIndex; index < firstIndex + model.range.indexCount * 3; index++) {
+            allIndicesOffset[index] = arrays.indices[index] + model.range.firstVertex;
+        }
+    }
 
-    size_t vertexOffset = 0;
-    size_t indexOffset = 0;
+    // models with few enough vertices get 16-bit indices. every model starts on a 4 byte boundary, so ranges of either
+    // type can share one buffer of uints. the BLAS builds and the hit shaders both read them through the model's range
+    std::vector<uint32_t> packedIndices;
 
-    // Copy the data to allVertices and allIndicesOffset
-    for (int i = 0; i < allObjectsData.size(); i++) {
-        const ObjData& objectData = allObjectsData[i];
+    for (ModelInfo& model : models) {
+        size_t firstIndex = model.range.indexOffset / sizeof(uint32_t);
+        size_t indexCount = model.range.indexCount * 3;
+        bool shortIndices = model.vertexCount <= std::numeric_limits<uint16_t>::max();
 
-        modelRanges[i] = ModelRange{
-                .firstVertex = static_cast<uint32_t>(vertexOffset / 4),
-                .indexOffset = static_cast<uint32_t>(indexOffset * sizeof(uint32_t)),
-                .indexCount  = static_cast<uint32_t>(objectData.indices.size() / 3)
-        };
+        auto packedOffset = static_cast<uint32_t>(packedIndices.size() * sizeof(uint32_t));
+        size_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+        VkIndexType indexType = shortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
 
-        // Copy vertices
-        std::copy(objectData.vertices.begin(), objectData.vertices.end(), allVertices.begin() + vertexOffset);
+        if (shortIndices) {
+            // two per uint, the first in the low half as UINT16 reads them on little endian hardware
+            for (size_t index = 0; index < indexCount; index += 2) {
+                uint32_t high = index + 1 < indexCount ? arrays.indices[firstIndex + index + 1] : 0;
+                packedIndices.push_back(arrays.indices[firstIndex + index] | high << 16);
+            }
+        } else {
+            packedIndices.insert(packedIndices.end(), arrays.indices.begin() + firstIndex, arrays.indices.begin() + firstIndex + indexCount);
+        }
 
-        // Copy indices with proper offset
-        for (uint32_t idx : objectData.indices) {
-            allIndicesOffset[indexOffset] = idx + (vertexOffset / 4);
-            allIndicesNonOffset[indexOffset++] = idx;
+        for (ShapeRange& shape : model.shapes) {
+            size_t shapeFirstIndex = shape.range.indexOffset / sizeof(uint32_t);
+            shape.range.indexOffset = static_cast<uint32_t>(packedOffset + (shapeFirstIndex - firstIndex) * indexSize);
+            shape.range.indexType = indexType;
         }
 
-        vertexOffset += objectData.vertices.size();
+        model.range.indexOffset = packedOffset;
+        model.range.indexType = indexType;
     }
 
     VkBufferUsageFlags usage = VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
                                VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
 
-    verticesBufferSize = allVertices.size();
+    vertexCount = arrays.vertices.size() / 4;
+    std::vector<QuantizationBounds> modelBounds(models.size(), QuantizationBounds{glm::vec3(0), glm::vec3(1)});
+
+#if QUANTIZE_VERTICES
+    // every unique model is quantized relative to its own bounds
+    std::vector<glm::uvec2> quantizedVertices(vertexCount);
+    maxQuantizationError = 0;
+
+    for (int i = 0; i < models.size(); i++) {
+        size_t firstVertex = models[i].range.firstVertex;
+        size_t modelVertexCount = models[i].vertexCount;
+        QuantizationBounds bounds = computeQuantizationBounds(arrays.vertices, firstVertex * 4, modelVertexCount * 4);
+
+        for (size_t vertex = firstVertex; vertex < firstVertex + modelVertexCount; vertex++) {
+            glm::vec3 position(arrays.vertices[vertex * 4], arrays.vertices[vertex * 4 + 1], arrays.vertices[vertex * 4 + 2]);
+            quantizedVertices[vertex] = quantizePosition(position, bounds);
+
+            float error = glm::length(dequantizePosition(quantizedVertices[vertex], bounds) - position);
+            maxQuantizationError = std::max(maxQuantizationError, error);
+        }
+
+        modelBounds[i] = bounds;
+        models[i].dequantizeTransform = getDequantizeTransform(bounds);
+    }
+
+    verticesBufferSize = quantizedVertices.size() * sizeof(glm::uvec2);
     verticesBuffer = reina::core::Buffer{
             logicalDevice,
             physicalDevice,
-            allVertices,
+            quantizedVertices,
             usage,
             VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     };
 
-    indicesBuffersSize = allIndicesOffset.size();
-    offsetIndicesBuffer = reina::core::Buffer{
+    // R16G16B16A16_SNORM is a required BLAS vertex format, but fall back to floats of the same quantized positions in
+    // case a driver doesn't advertise it. the quantized space stays the same so instance transforms don't change
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, VK_FORMAT_R16G16B16A16_SNORM, &formatProperties);
+
+    if (formatProperties.bufferFeatures & VK_FORMAT_FEATURE_ACCELERATION_STRUCTURE_VERTEX_BUFFER_BIT_KHR) {
+        blasVertexFormat = VK_FORMAT_R16G16B16A16_SNORM;
+        blasVertexStride = sizeof(glm::uvec2);
+    } else {
+        std::vector<float> normalizedVertices(vertexCount * 4);
+        for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+            glm::vec3 normalized = dequantizePosition(quantizedVertices[vertex], {glm::vec3(0), glm::vec3(1)});
+            normalizedVertices[vertex * 4] = normalized.x;
+            normalizedVertices[vertex * 4 + 1] = normalized.y;
+            normalizedVertices[vertex * 4 + 2] = normalized.z;
+        }
+
+        blasVertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
+        blasVertexStride = 4 * sizeof(float);
+        blasVerticesBuffer = reina::core::Buffer{
+                logicalDevice,
+                physicalDevice,
+                normalizedVertices,
+                usage,
+                VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        };
+    }
+#else
+    maxQuantizationError = 0;
+    blasVertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
+    blasVertexStride = 4 * sizeof(float);
+
+    verticesBufferSize = arrays.vertices.size() * sizeof(float);
+    verticesBuffer = reina::core::Buffer{
             logicalDevice,
             physicalDevice,
-            allIndicesOffset,
+            arrays.vertices,
             usage,
             VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     };
-    nonOffsetIndicesBuffer = reina::core::Buffer{
+#endif
+
+    // interleaved per-vertex attributes: octahedral normal and half-float UV. normals go into the same (quantized) space
+    // as the positions, so the hit shader transforms both with the instance matrix
+    std::vector<glm::uvec2> attributes(vertexCount);
+
+    for (int i = 0; i < models.size(); i++) {
+        size_t firstVertex = models[i].range.firstVertex;
+
+        for (size_t vertex = firstVertex; vertex < firstVertex + models[i].vertexCount; vertex++) {
+            glm::vec3 normal(0, 0, 1);
+            if (models[i].hasNormals) {
+                glm::vec3 objNormal(arrays.normals[vertex * 3], arrays.normals[vertex * 3 + 1], arrays.normals[vertex * 3 + 2]);
+                objNormal *= modelBounds[i].halfExtent;
+
+                if (glm::length(objNormal) > 0) {
+                    normal = glm::normalize(objNormal);
+                }
+            }
+
+            glm::vec2 uv(arrays.uvs[vertex * 2], arrays.uvs[vertex * 2 + 1]);
+            attributes[vertex] = glm::uvec2(encodeOctahedral(normal), glm::packHalf2x16(uv));
+        }
+    }
+
+    attributesBuffer = reina::core::Buffer{
             logicalDevice,
             physicalDevice,
-            allIndicesNonOffset,
+            attributes,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            static_cast<VkMemoryAllocateFlags>(0),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    };
+
+    indicesBufferSize = packedIndices.size() * sizeof(uint32_t);
+    fetchMissesPerTriangle = vertexCount > 0 ? simulateVertexFetchMisses(allIndicesOffset, verticesBufferSize / vertexCount) : 0;
+
+    indicesBuffer = reina::core::Buffer{
+            logicalDevice,
+            physicalDevice,
+            packedIndices,
             usage,
             VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     };
 }
 
-reina::graphics::ObjData reina::graphics::Models::getObjData(const std::string& filepath) {
-    tinyobj::ObjReader reader;
-    reader.ParseFromFile(filepath);
+reina::graphics::Models::ModelInfo reina::graphics::Models::appendObj(const std::string& filepath, MeshArrays& arrays, bool optimize) {
+    ObjRange obj = parseObj(filepath, arrays);
 
-    if (!reader.Valid()) {
-        throw std::runtime_error("Error reading OBJ:\n" + reader.Error());
+    if (optimize) {
+        optimizeMesh(arrays, obj);
     }
 
-    std::vector<tinyobj::real_t> tinyobjVertices = reader.GetAttrib().GetVertices();
-    // convert from 3 floats per vertex to 4 floats per vertex. std::round removes any potential floating-point inaccuracies
-    std::vector<float> objVertices(static_cast<int>(std::round(static_cast<double>(tinyobjVertices.size()) * 4.0/3)));
+    auto firstVertex = static_cast<uint32_t>(obj.firstVertex);
 
-    for (int vertex = 0; vertex < tinyobjVertices.size() / 3; vertex++) {
-        objVertices[vertex * 4] = tinyobjVertices[vertex * 3];
-        objVertices[vertex * 4 + 1] = tinyobjVertices[vertex * 3 + 1];
-        objVertices[vertex * 4 + 2] = tinyobjVertices[vertex * 3 + 2];
-        objVertices[vertex * 4 + 3] = 0;
-    }
+    ModelInfo model{};
+    model.hasNormals = obj.hasNormals;
+    model.vertexCount = static_cast<uint32_t>(obj.vertexCount);
+    model.range = ModelRange{
+            .firstVertex = firstVertex,
+            .indexOffset = static_cast<uint32_t>(obj.firstIndex * sizeof(uint32_t)),
+            .indexCount  = static_cast<uint32_t>(obj.indexCount / 3)
+    };
 
-    const std::vector<tinyobj::shape_t>& shapes = reader.GetShapes();
-    if (shapes.size() != 1) {
-        throw std::runtime_error("Several shapes to parse; need only one");
+    for (const ObjShape& shape : obj.shapes) {
+        model.shapes.push_back(ShapeRange{
+                shape.name,
+                ModelRange{
+                        .firstVertex = firstVertex,
+                        .indexOffset = static_cast<uint32_t>(shape.firstIndex * sizeof(uint32_t)),
+                        .indexCount  = static_cast<uint32_t>(shape.indexCount / 3)
+                }
+        });
     }
 
-    std::vector<uint32_t> objIndices(shapes[0].mesh.indices.size());
-    for (int i = 0; i < shapes[0].mesh.indices.size(); i++) {
-        objIndices[i] = shapes[0].mesh.indices[i].vertex_index;
+    return model;
+}
+
+uint64_t reina::graphics::Models::hashModel(const MeshArrays& arrays, const ModelInfo& model) {
+    // 64-bit FNV-1a over the vertex, index and attribute payload
+    uint64_t hash = 14695981039346656037ull;
+
+    auto hashBytes = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    size_t firstVertex = model.range.firstVertex;
+    size_t firstIndex = model.range.indexOffset / sizeof(uint32_t);
+
+    // so the boundaries between the arrays are part of the hash
+    uint64_t counts[] = {model.vertexCount, model.range.indexCount, model.hasNormals};
+    hashBytes(counts, sizeof(counts));
+
+    hashBytes(arrays.vertices.data() + firstVertex * 4, model.vertexCount * 4 * sizeof(float));
+    hashBytes(arrays.indices.data() + firstIndex, model.range.indexCount * 3 * sizeof(uint32_t));
+    hashBytes(arrays.normals.data() + firstVertex * 3, model.vertexCount * 3 * sizeof(float));
+    hashBytes(arrays.uvs.data() + firstVertex * 2, model.vertexCount * 2 * sizeof(float));
+
+    return hash;
+}
+
+bool reina::graphics::Models::sameGeometry(const MeshArrays& arrays, const ModelInfo& a, const ModelInfo& b) {
+    if (a.vertexCount != b.vertexCount || a.range.indexCount != b.range.indexCount || a.hasNormals != b.hasNormals) {
+        return false;
     }
 
-    return {objVertices, objIndices};
+    auto sameRange = [](const auto& array, size_t firstA, size_t firstB, size_t count) {
+        return std::equal(array.begin() + firstA, array.begin() + firstA + count, array.begin() + firstB);
+    };
+
+    size_t vertexCount = a.vertexCount;
+    size_t indexCount = a.range.indexCount * 3;
+
+    return sameRange(arrays.vertices, a.range.firstVertex * 4, b.range.firstVertex * 4, vertexCount * 4) &&
+           sameRange(arrays.indices, a.range.indexOffset / sizeof(uint32_t), b.range.indexOffset / sizeof(uint32_t), indexCount) &&
+           sameRange(arrays.normals, a.range.firstVertex * 3, b.range.firstVertex * 3, vertexCount * 3) &&
+           sameRange(arrays.uvs, a.range.firstVertex * 2, b.range.firstVertex * 2, vertexCount * 2);
+}
+
+size_t reina::graphics::Models::getVertexCount() const {
+    return vertexCount;
 }
 
 size_t reina::graphics::Models::getVerticesBufferSize() const {
     return verticesBufferSize;
 }
 
-size_t reina::graphics::Models::getIndicesBuffersSize() const {
-    return indicesBuffersSize;
+size_t reina::graphics::Models::getIndicesBufferSize() const {
+    return indicesBufferSize;
 }
 
 const reina::core::Buffer& reina::graphics::Models::getVerticesBuffer() const {
     return verticesBuffer.value();
 }
 
-const reina::core::Buffer& reina::graphics::Models::getOffsetIndicesBuffer() const {
-    return offsetIndicesBuffer.value();
+const reina::core::Buffer& reina::graphics::Models::getBlasVerticesBuffer() const {
+    return blasVerticesBuffer.has_value() ? blasVerticesBuffer.value() : verticesBuffer.value();
 }
 
-const reina::core::Buffer& reina::graphics::Models::getNonOffsetIndicesBuffer() const {
-    return nonOffsetIndicesBuffer.value();
+VkFormat reina::graphics::Models::getBlasVertexFormat() const {
+    return blasVertexFormat;
+}
+
+VkDeviceSize reina::graphics::Models::getBlasVertexStride() const {
+    return blasVertexStride;
+}
+
+const reina::core::Buffer& reina::graphics::Models::getIndicesBuffer() const {
+    return indicesBuffer.value();
 }
 
 reina::graphics::ModelRange reina::graphics::Models::getModelRange(int index) const {
     // todo: do input validation
-    return modelRanges[index];
+    return models[modelIndices[index]].range;
+}
+
+const std::vector<reina::graphics::ShapeRange>& reina::graphics::Models::getShapeRanges(int index) const {
+    return models[modelIndices[index]].shapes;
+}
+
+uint64_t reina::graphics::Models::getContentHash(int index) const {
+    return models[modelIndices[index]].contentHash;
+}
+
+const reina::core::Buffer& reina::graphics::Models::getAttributesBuffer() const {
+    return attributesBuffer.value();
+}
+
+bool reina::graphics::Models::hasVertexNormals(int index) const {
+    return models[modelIndices[index]].hasNormals;
+}
+
+const glm::mat4& reina::graphics::Models::getDequantizeTransform(int index) const {
+    return models[modelIndices[index]].dequantizeTransform;
+}
+
+float reina::graphics::Models::getMaxQuantizationError() const {
+    return maxQuantizationError;
+}
+
+double reina::graphics::Models::getFetchMissesPerTriangle() const {
+    return fetchMissesPerTriangle;
 }
 
 void reina::graphics::Models::destroy(VkDevice logicalDevice) {
     if (verticesBuffer.has_value()) {
         verticesBuffer.value().destroy(logicalDevice);
-    } if (offsetIndicesBuffer.has_value()) {
-        offsetIndicesBuffer.value().destroy(logicalDevice);
-    } if (nonOffsetIndicesBuffer.has_value()) {
-        nonOffsetIndicesBuffer.value().destroy(logicalDevice);
+    } if (attributesBuffer.has_value()) {
+        attributesBuffer.value().destroy(logicalDevice);
+    } if (blasVerticesBuffer.has_value()) {
+        blasVerticesBuffer.value().destroy(logicalDevice);
+    } if (indicesBuffer.has_value()) {
+        indicesBuffer.value().destroy(logicalDevice);
     }
 }
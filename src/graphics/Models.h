@@ -4,47 +4,86 @@
 #include <vector>
 #include <string>
 #include <optional>
+#include <glm/glm.hpp>
 
+#include "ObjParser.h"
 #include "../core/Buffer.h"
 
 namespace reina::graphics {
     struct ModelRange {
         uint32_t firstVertex;
-        uint32_t indexOffset;
-        uint32_t indexCount;
+        uint32_t indexOffset;  // in bytes, into the indices buffer
+        uint32_t indexCount;   // in triangles
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;  // UINT16 for models with fewer than 65536 vertices
     };
 
-    struct ObjData {
-        std::vector<float> vertices;
-        std::vector<uint32_t> indices;
+    struct ShapeRange {
+        std::string name;
+        ModelRange range;  // a sub-range of its model's indices, sharing the model's vertices
     };
 
     class Models {
     public:
-        Models(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::vector<std::string>& modelFilepaths);
+        /**
+         * @param optimizeMeshes reorder triangles and vertices for locality as they're loaded, see optimizeMesh
+         */
+        Models(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::vector<std::string>& modelFilepaths, bool optimizeMeshes = true);
 
-        [[nodiscard]] size_t getVerticesBufferSize() const;
-        [[nodiscard]] size_t getIndicesBuffersSize() const;
+        [[nodiscard]] size_t getVertexCount() const;
+        [[nodiscard]] size_t getVerticesBufferSize() const;  // in bytes, of the vertex stream the hit shaders read
+        [[nodiscard]] size_t getIndicesBufferSize() const;  // in bytes
 
         [[nodiscard]] const reina::core::Buffer& getVerticesBuffer() const;
-        [[nodiscard]] const reina::core::Buffer& getOffsetIndicesBuffer() const;
-        [[nodiscard]] const reina::core::Buffer& getNonOffsetIndicesBuffer() const;
+        [[nodiscard]] const reina::core::Buffer& getBlasVerticesBuffer() const;
+        [[nodiscard]] VkFormat getBlasVertexFormat() const;
+        [[nodiscard]] VkDeviceSize getBlasVertexStride() const;
+        [[nodiscard]] const reina::core::Buffer& getAttributesBuffer() const;  // per vertex: octahedral normal, half UV
+        [[nodiscard]] const reina::core::Buffer& getIndicesBuffer() const;  // model-local, 16 or 32 bits per model range
 
-        [[nodiscard]] ModelRange getModelRange(int index) const;
+        [[nodiscard]] ModelRange getModelRange(int index) const;  // all shapes of the model
+        [[nodiscard]] const std::vector<ShapeRange>& getShapeRanges(int index) const;
+        [[nodiscard]] uint64_t getContentHash(int index) const;  // equal for models with identical geometry
+        [[nodiscard]] bool hasVertexNormals(int index) const;
+
+        /**
+         * Maps the model's quantized vertex space to object space, see QUANTIZE_VERTICES in polyglot/common.h. Identity
+         * when vertices aren't quantized. Must be applied before the instance transform.
+         */
+        [[nodiscard]] const glm::mat4& getDequantizeTransform(int index) const;
+        [[nodiscard]] float getMaxQuantizationError() const;  // in object space units, over all models
+        [[nodiscard]] double getFetchMissesPerTriangle() const;  // see simulateVertexFetchMisses, over all models
 
         void destroy(VkDevice logicalDevice);
 
     private:
-        [[nodiscard]] static ObjData getObjData(const std::string& filepath);
+        struct ModelInfo {
+            ModelRange range;
+            uint32_t vertexCount;
+            std::vector<ShapeRange> shapes;
+            bool hasNormals;
+            uint64_t contentHash;
+            glm::mat4 dequantizeTransform = glm::mat4(1.0f);
+        };
+
+        [[nodiscard]] static ModelInfo appendObj(const std::string& filepath, MeshArrays& arrays, bool optimize);
+        [[nodiscard]] static uint64_t hashModel(const MeshArrays& arrays, const ModelInfo& model);
+        [[nodiscard]] static bool sameGeometry(const MeshArrays& arrays, const ModelInfo& a, const ModelInfo& b);
 
         std::optional<reina::core::Buffer> verticesBuffer;
-        std::optional<reina::core::Buffer> offsetIndicesBuffer;
-        std::optional<reina::core::Buffer> nonOffsetIndicesBuffer;
+        std::optional<reina::core::Buffer> blasVerticesBuffer;  // only if the BLAS can't be built from verticesBuffer
+        std::optional<reina::core::Buffer> attributesBuffer;
+        std::optional<reina::core::Buffer> indicesBuffer;
 
+        size_t vertexCount;
         size_t verticesBufferSize;
-        size_t indicesBuffersSize;
+        VkFormat blasVertexFormat;
+        VkDeviceSize blasVertexStride;
+        float maxQuantizationError;
+        double fetchMissesPerTriangle;
+        size_t indicesBufferSize;
 
-        std::vector<ModelRange> modelRanges;
+        std::vector<ModelInfo> models;    // unique models
+        std::vector<size_t> modelIndices;  // index into models for every filepath passed to the constructor
     };
 }
 
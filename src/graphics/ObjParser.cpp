@@ -0,0 +1,751 @@
+#include "ObjParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#include "../tools/MappedFile.h"
+
+namespace {
+    constexpr int32_t ABSENT = std::numeric_limits<int32_t>::min();
+    constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+    struct VertexKeyHash {
+        size_t operator()(const std::tuple<int, int, int>& key) const {
+            auto [position, normal, uv] = key;
+            size_t hash = std::hash<int>{}(position);
+            hash = hash * 31 + std::hash<int>{}(normal);
+            return hash * 31 + std::hash<int>{}(uv);
+        }
+    };
+
+    struct ParseError {
+        const char* position;
+        const char* message;
+    };
+
+    enum CornerFlags : uint8_t {
+        RELATIVE_POSITION = 1,
+        RELATIVE_UV = 2,
+        RELATIVE_NORMAL = 4
+    };
+
+    // a face corner with 0-based indices. negative OBJ indices depend on how many elements the earlier chunks have, so
+    // they're stored relative to the chunk start and flagged until resolveIndex runs
+    struct Corner {
+        int32_t position;
+        int32_t uv;
+        int32_t normal;
+        uint8_t relative;
+    };
+
+    struct ShapeEvent {
+        std::string name;  // of an o or g
+        size_t triangle;  // first triangle after the event, within the chunk
+    };
+
+    struct Chunk {
+        const char* begin;
+        const char* end;
+
+        std::vector<float> positions;  // 3 floats each
+        std::vector<float> normals;    // 3 floats each
+        std::vector<float> uvs;        // 2 floats each
+        std::vector<Corner> corners;   // 3 per triangle
+        std::vector<ShapeEvent> events;
+        std::vector<size_t> quads;     // first triangle of each quad, see splitQuad
+
+        // elements in all earlier chunks
+        size_t positionsBefore = 0;
+        size_t normalsBefore = 0;
+        size_t uvsBefore = 0;
+        size_t trianglesBefore = 0;
+
+        std::exception_ptr error;
+    };
+
+    template<typename F>
+    void forEachChunk(std::vector<Chunk>& chunks, F&& function) {
+        std::vector<std::thread> threads;
+        threads.reserve(chunks.size());
+
+        for (Chunk& chunk : chunks) {
+            threads.emplace_back([&chunk, &function]() {
+                try {
+                    function(chunk);
+                } catch (...) {
+                    chunk.error = std::current_exception();
+                }
+            });
+        }
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    bool isDigit(char c) {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && isBlank(*p)) {
+            p++;
+        }
+
+        return p;
+    }
+
+    const char* nextLine(const char* p, const char* end) {
+        const auto* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        return newline == nullptr ? end : newline + 1;
+    }
+
+    double powerOfTen(int exponent) {
+        // exactly representable, so the common short decimals round correctly
+        static constexpr double exact[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        if (exponent >= 0 && exponent <= 22) {
+            return exact[exponent];
+        } else if (exponent < 0 && exponent >= -22) {
+            return 1.0 / exact[-exponent];
+        }
+
+        return std::pow(10.0, exponent);
+    }
+
+    /**
+     * Decimal to float without locale lookups or copying the token, which is what makes strtod slow. Accumulates up
+     * to 19 significant digits in an integer and scales once at the end.
+     */
+    float parseFloat(const char*& p, const char* end) {
+        p = skipBlanks(p, end);
+        const char* start = p;
+
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            p++;
+        }
+
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        int significantDigits = 0;
+        bool anyDigits = false;
+
+        for (; p < end && isDigit(*p); p++) {
+            anyDigits = true;
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                significantDigits += mantissa != 0;
+            } else {
+                exponent++;
+            }
+        }
+
+        if (p < end && *p == '.') {
+            for (p++; p < end && isDigit(*p); p++) {
+                anyDigits = true;
+                if (significantDigits < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    significantDigits += mantissa != 0;
+                    exponent--;
+                }
+            }
+        }
+
+        if (!anyDigits) {
+            // nan, inf and friends
+            char buffer[32]{};
+            const char* tokenEnd = start;
+            while (tokenEnd < end && !isBlank(*tokenEnd) && *tokenEnd != '\n' && tokenEnd - start < 31) {
+                tokenEnd++;
+            }
+
+            std::memcpy(buffer, start, tokenEnd - start);
+            char* parsedEnd;
+            float value = std::strtof(buffer, &parsedEnd);
+
+            if (parsedEnd == buffer) {
+                throw ParseError{start, "expected a number"};
+            }
+
+            p = start + (parsedEnd - buffer);
+            return value;
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            bool negativeExponent = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                negativeExponent = *p == '-';
+                p++;
+            }
+
+            int explicitExponent = 0;
+            for (; p < end && isDigit(*p); p++) {
+                explicitExponent = std::min(explicitExponent * 10 + (*p - '0'), 100000);
+            }
+
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        double value = static_cast<double>(mantissa) * powerOfTen(exponent);
+        return static_cast<float>(negative ? -value : value);
+    }
+
+    int32_t parseInt(const char*& p, const char* end) {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            p++;
+        }
+
+        if (p >= end || !isDigit(*p)) {
+            throw ParseError{p, "expected an index"};
+        }
+
+        int64_t value = 0;
+        for (; p < end && isDigit(*p); p++) {
+            value = std::min<int64_t>(value * 10 + (*p - '0'), std::numeric_limits<int32_t>::max());
+        }
+
+        return static_cast<int32_t>(negative ? -value : value);
+    }
+
+    std::string readName(const char* p, const char* end) {
+        p = skipBlanks(p, end);
+        const char* nameEnd = p;
+        while (nameEnd < end && *nameEnd != '\n') {
+            nameEnd++;
+        }
+
+        while (nameEnd > p && isBlank(nameEnd[-1])) {
+            nameEnd--;
+        }
+
+        return {p, nameEnd};
+    }
+
+    /**
+     * First pass over a chunk, independent of the others. Negative indices are kept relative to the chunk since the
+     * element counts of the earlier chunks are only known once every chunk is parsed.
+     */
+    void parseChunk(Chunk& chunk) {
+        const char* p = chunk.begin;
+        const char* end = chunk.end;
+
+        while (p < end) {
+            // a comment can also follow the data of a line, so every line is parsed only up to its first '#'
+            const char* nextLineStart = nextLine(p, end);
+            const char* comment = static_cast<const char*>(std::memchr(p, '#', nextLineStart - p));
+            const char* lineEnd = comment != nullptr ? comment : nextLineStart;
+
+            p = skipBlanks(p, lineEnd);
+            if (p >= lineEnd) {
+                p = nextLineStart;
+                continue;
+            }
+
+            const char* lineStart = p;
+            char next = p + 1 < lineEnd ? p[1] : '\n';
+
+            if (*p == 'v' && isBlank(next)) {
+                p++;
+                chunk.positions.push_back(parseFloat(p, lineEnd));
+                chunk.positions.push_back(parseFloat(p, lineEnd));
+                chunk.positions.push_back(parseFloat(p, lineEnd));
+            } else if (*p == 'v' && next == 'n' && p + 2 < lineEnd && isBlank(p[2])) {
+                p += 2;
+                chunk.normals.push_back(parseFloat(p, lineEnd));
+                chunk.normals.push_back(parseFloat(p, lineEnd));
+                chunk.normals.push_back(parseFloat(p, lineEnd));
+            } else if (*p == 'v' && next == 't' && p + 2 < lineEnd && isBlank(p[2])) {
+                p += 2;
+                chunk.uvs.push_back(parseFloat(p, lineEnd));
+
+                // the v coordinate is optional
+                const char* afterU = skipBlanks(p, lineEnd);
+                chunk.uvs.push_back(afterU < lineEnd && *afterU != '\n' ? parseFloat(p, lineEnd) : 0.0f);
+            } else if (*p == 'f' && isBlank(next)) {
+                p++;
+
+                Corner first{};
+                Corner previous{};
+                int cornerCount = 0;
+
+                while (true) {
+                    p = skipBlanks(p, lineEnd);
+                    if (p >= lineEnd || *p == '\n') {
+                        break;
+                    }
+
+                    const char* cornerStart = p;
+                    Corner corner{ABSENT, ABSENT, ABSENT, 0};
+
+                    auto store = [&](int32_t objIndex, size_t countInChunk, uint8_t relativeFlag) {
+                        if (objIndex == 0) {
+                            throw ParseError{cornerStart, "index 0 is not valid in OBJ"};
+                        } else if (objIndex < 0) {
+                            corner.relative |= relativeFlag;
+                            return static_cast<int32_t>(countInChunk) + objIndex;
+                        }
+
+                        return objIndex - 1;
+                    };
+
+                    corner.position = store(parseInt(p, lineEnd), chunk.positions.size() / 3, RELATIVE_POSITION);
+
+                    if (p < lineEnd && *p == '/') {
+                        p++;
+                        if (p < lineEnd && *p != '/') {
+                            corner.uv = store(parseInt(p, lineEnd), chunk.uvs.size() / 2, RELATIVE_UV);
+                        }
+
+                        if (p < lineEnd && *p == '/') {
+                            p++;
+                            corner.normal = store(parseInt(p, lineEnd), chunk.normals.size() / 3, RELATIVE_NORMAL);
+                        }
+                    }
+
+                    if (cornerCount == 0) {
+                        first = corner;
+                    } else if (cornerCount >= 2) {
+                        chunk.corners.push_back(first);
+                        chunk.corners.push_back(previous);
+                        chunk.corners.push_back(corner);
+                    }
+
+                    previous = corner;
+                    cornerCount++;
+                }
+
+                if (cornerCount < 3) {
+                    throw ParseError{lineStart, "face with fewer than 3 vertices"};
+                } else if (cornerCount == 4) {
+                    chunk.quads.push_back(chunk.corners.size() / 3 - 2);
+                }
+            } else if ((*p == 'o' || *p == 'g') && (isBlank(next) || next == '\n')) {
+                chunk.events.push_back({readName(p + 1, lineEnd), chunk.corners.size() / 3});
+            }
+
+            p = nextLineStart;
+        }
+    }
+
+    // to an index into the whole file, or ABSENT if it's out of range
+    int32_t resolveIndex(int32_t stored, bool relative, size_t countBefore, size_t total) {
+        if (stored == ABSENT) {
+            return ABSENT;
+        }
+
+        int64_t index = relative ? static_cast<int64_t>(stored) + countBefore : stored;
+        return index >= 0 && index < static_cast<int64_t>(total) ? static_cast<int32_t>(index) : ABSENT;
+    }
+
+    /**
+     * Splits a quad along its shorter diagonal, like tinyobjloader, so meshes triangulate the same as with the old
+     * loader. The fan triangulation in parseChunk always splits along 0-2.
+     */
+    void splitQuad(Corner* corners, const std::vector<float>& positions) {
+        auto distanceSquared = [&positions](int32_t a, int32_t b) {
+            float x = positions[b * 3] - positions[a * 3];
+            float y = positions[b * 3 + 1] - positions[a * 3 + 1];
+            float z = positions[b * 3 + 2] - positions[a * 3 + 2];
+            return x * x + y * y + z * z;
+        };
+
+        Corner c0 = corners[0];
+        Corner c1 = corners[1];
+        Corner c2 = corners[2];
+        Corner c3 = corners[5];
+
+        if (distanceSquared(c0.position, c2.position) >= distanceSquared(c1.position, c3.position)) {
+            corners[0] = c0;
+            corners[1] = c1;
+            corners[2] = c3;
+            corners[3] = c1;
+            corners[4] = c2;
+            corners[5] = c3;
+        }
+    }
+
+    std::vector<float> gather(const std::vector<Chunk>& chunks, size_t count, std::vector<float> Chunk::* member) {
+        std::vector<float> all;
+        all.reserve(count);
+
+        for (const Chunk& chunk : chunks) {
+            const std::vector<float>& values = chunk.*member;
+            all.insert(all.end(), values.begin(), values.end());
+        }
+
+        return all;
+    }
+
+    size_t lineNumber(const char* fileStart, const char* position) {
+        return 1 + std::count(fileStart, position, '\n');
+    }
+
+    void appendShapes(const std::vector<Chunk>& chunks, size_t firstIndex, reina::graphics::ObjRange& range) {
+        std::string shapeName;
+        size_t shapeFirstTriangle = 0;
+        size_t totalTriangles = range.indexCount / 3;
+
+        auto closeShape = [&](size_t endTriangle) {
+            if (endTriangle > shapeFirstTriangle) {
+                range.shapes.push_back({
+                        shapeName,
+                        firstIndex + shapeFirstTriangle * 3,
+                        (endTriangle - shapeFirstTriangle) * 3
+                });
+            }
+        };
+
+        for (const Chunk& chunk : chunks) {
+            for (const ShapeEvent& event : chunk.events) {
+                size_t triangle = chunk.trianglesBefore + event.triangle;
+
+                closeShape(triangle);
+                shapeName = event.name;
+                shapeFirstTriangle = triangle;
+            }
+        }
+
+        closeShape(totalTriangles);
+    }
+}
+
+reina::graphics::ObjRange reina::graphics::parseObj(const std::string& filepath, MeshArrays& arrays) {
+    reina::tools::MappedFile file{filepath};
+    const char* data = file.getData();
+    size_t size = file.getSize();
+
+    // split at line boundaries, at least a megabyte per chunk so small files don't pay for threads
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::clamp<size_t>(size / MIN_CHUNK_SIZE, 1, threadCount);
+
+    std::vector<Chunk> chunks(chunkCount);
+    const char* chunkStart = data;
+    for (size_t i = 0; i < chunkCount; i++) {
+        const char* chunkEnd = i + 1 == chunkCount ? data + size : nextLine(std::max(chunkStart, data + size * (i + 1) / chunkCount), data + size);
+
+        chunks[i].begin = chunkStart;
+        chunks[i].end = chunkEnd;
+        chunkStart = chunkEnd;
+    }
+
+    forEachChunk(chunks, parseChunk);
+
+    for (Chunk& chunk : chunks) {
+        if (!chunk.error) {
+            continue;
+        }
+
+        try {
+            std::rethrow_exception(chunk.error);
+        } catch (const ParseError& error) {
+            throw std::runtime_error("Error reading OBJ " + filepath + " on line " + std::to_string(lineNumber(data, error.position)) + ": " + error.message);
+        }
+    }
+
+    size_t totalPositions = 0;
+    size_t totalNormals = 0;
+    size_t totalUvs = 0;
+    size_t totalTriangles = 0;
+
+    for (Chunk& chunk : chunks) {
+        chunk.positionsBefore = totalPositions;
+        chunk.normalsBefore = totalNormals;
+        chunk.uvsBefore = totalUvs;
+        chunk.trianglesBefore = totalTriangles;
+
+        totalPositions += chunk.positions.size() / 3;
+        totalNormals += chunk.normals.size() / 3;
+        totalUvs += chunk.uvs.size() / 2;
+        totalTriangles += chunk.corners.size() / 3;
+    }
+
+    if (totalTriangles == 0) {
+        throw std::runtime_error("OBJ has no faces: " + filepath);
+    }
+
+    std::vector<float> positions = gather(chunks, totalPositions * 3, &Chunk::positions);
+
+    // make every index absolute. out of range normals and UVs are dropped like tinyobj does, positions are an error
+    std::vector<char> chunkHasAllNormals(chunks.size());
+    std::vector<char> chunkHasUvs(chunks.size());
+
+    forEachChunk(chunks, [&](Chunk& chunk) {
+        size_t chunkIndex = &chunk - chunks.data();
+        bool allNormals = true;
+        bool anyUvs = false;
+
+        for (Corner& corner : chunk.corners) {
+            corner.position = resolveIndex(corner.position, corner.relative & RELATIVE_POSITION, chunk.positionsBefore, totalPositions);
+            corner.normal = resolveIndex(corner.normal, corner.relative & RELATIVE_NORMAL, chunk.normalsBefore, totalNormals);
+            corner.uv = resolveIndex(corner.uv, corner.relative & RELATIVE_UV, chunk.uvsBefore, totalUvs);
+
+            if (corner.position == ABSENT) {
+                throw std::runtime_error("Error reading OBJ " + filepath + ": vertex index out of range");
+            }
+
+            allNormals &= corner.normal != ABSENT;
+            anyUvs |= corner.uv != ABSENT;
+        }
+
+        for (size_t triangle : chunk.quads) {
+            splitQuad(&chunk.corners[triangle * 3], positions);
+        }
+
+        chunkHasAllNormals[chunkIndex] = allNormals;
+        chunkHasUvs[chunkIndex] = anyUvs;
+    });
+
+    for (Chunk& chunk : chunks) {
+        if (chunk.error) {
+            std::rethrow_exception(chunk.error);
+        }
+    }
+
+    ObjRange range{};
+    range.hasNormals = totalNormals > 0 && std::all_of(chunkHasAllNormals.begin(), chunkHasAllNormals.end(), [](char c) { return c != 0; });
+    bool hasUvs = std::any_of(chunkHasUvs.begin(), chunkHasUvs.end(), [](char c) { return c != 0; });
+
+    range.firstVertex = arrays.vertices.size() / 4;
+    range.firstIndex = arrays.indices.size();
+    range.indexCount = totalTriangles * 3;
+
+    arrays.indices.resize(range.firstIndex + range.indexCount);
+
+    if (!range.hasNormals && !hasUvs) {
+        // positions only: the OBJ vertices are the final vertices, except for those no face uses, which would still
+        // end up in the BLAS vertex buffer. they are dropped in file order, then every chunk writes its part in parallel
+        constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(totalPositions, UNUSED);
+        for (const Chunk& chunk : chunks) {
+            for (const Corner& corner : chunk.corners) {
+                remap[corner.position] = 0;
+            }
+        }
+
+        uint32_t usedPositions = 0;
+        for (uint32_t& index : remap) {
+            if (index != UNUSED) {
+                index = usedPositions++;
+            }
+        }
+
+        range.vertexCount = usedPositions;
+
+        arrays.vertices.resize((range.firstVertex + usedPositions) * 4);
+        arrays.normals.resize((range.firstVertex + usedPositions) * 3, 0.0f);
+        arrays.uvs.resize((range.firstVertex + usedPositions) * 2, 0.0f);
+
+        forEachChunk(chunks, [&](Chunk& chunk) {
+            const float* chunkPositions = positions.data() + chunk.positionsBefore * 3;
+            float* vertices = arrays.vertices.data() + range.firstVertex * 4;
+            for (size_t i = 0; i < chunk.positions.size() / 3; i++) {
+                uint32_t vertex = remap[chunk.positionsBefore + i];
+                if (vertex == UNUSED) {
+                    continue;
+                }
+
+                vertices[vertex * 4] = chunkPositions[i * 3];
+                vertices[vertex * 4 + 1] = chunkPositions[i * 3 + 1];
+                vertices[vertex * 4 + 2] = chunkPositions[i * 3 + 2];
+                vertices[vertex * 4 + 3] = 0;
+            }
+
+            uint32_t* indices = arrays.indices.data() + range.firstIndex + chunk.trianglesBefore * 3;
+            for (size_t i = 0; i < chunk.corners.size(); i++) {
+                indices[i] = remap[chunk.corners[i].position];
+            }
+        });
+    } else {
+        // every unique position/normal/UV combination becomes a vertex, in first use order
+        std::vector<float> normals = range.hasNormals ? gather(chunks, totalNormals * 3, &Chunk::normals) : std::vector<float>{};
+        std::vector<float> uvs = hasUvs ? gather(chunks, totalUvs * 2, &Chunk::uvs) : std::vector<float>{};
+
+        std::unordered_map<std::tuple<int, int, int>, uint32_t, VertexKeyHash> uniqueVertices;
+        uniqueVertices.reserve(totalPositions);
+
+        uint32_t* indices = arrays.indices.data() + range.firstIndex;
+
+        for (const Chunk& chunk : chunks) {
+            for (const Corner& corner : chunk.corners) {
+                int normal = range.hasNormals ? corner.normal : ABSENT;
+                int uv = hasUvs ? corner.uv : ABSENT;
+
+                auto [it, inserted] = uniqueVertices.try_emplace(
+                        std::make_tuple(corner.position, normal, uv),
+                        static_cast<uint32_t>(arrays.vertices.size() / 4 - range.firstVertex)
+                );
+
+                if (inserted) {
+                    arrays.vertices.insert(arrays.vertices.end(), {
+                            positions[corner.position * 3],
+                            positions[corner.position * 3 + 1],
+                            positions[corner.position * 3 + 2],
+                            0
+                    });
+
+                    if (normal != ABSENT) {
+                        arrays.normals.insert(arrays.normals.end(), {normals[normal * 3], normals[normal * 3 + 1], normals[normal * 3 + 2]});
+                    } else {
+                        arrays.normals.insert(arrays.normals.end(), {0, 0, 0});
+                    }
+
+                    arrays.uvs.push_back(uv != ABSENT ? uvs[uv * 2] : 0);
+                    arrays.uvs.push_back(uv != ABSENT ? uvs[uv * 2 + 1] : 0);
+                }
+
+                *indices++ = it->second;
+            }
+        }
+
+        range.vertexCount = arrays.vertices.size() / 4 - range.firstVertex;
+    }
+
+    appendShapes(chunks, range.firstIndex, range);
+    return range;
+}
+
+reina::graphics::ObjRange reina::graphics::parseObjTinyObj(const std::string& filepath, MeshArrays& arrays) {
+    tinyobj::ObjReader reader;
+    reader.ParseFromFile(filepath);
+
+    if (!reader.Valid()) {
+        throw std::runtime_error("Error reading OBJ:\n" + reader.Error());
+    }
+
+    const tinyobj::attrib_t& attrib = reader.GetAttrib();
+    const std::vector<tinyobj::shape_t>& shapes = reader.GetShapes();
+
+    size_t normalCount = attrib.normals.size() / 3;
+    size_t uvCount = attrib.texcoords.size() / 2;
+
+    // a model only gets smooth normals if every corner has a valid one, otherwise the hit shader uses geometric
+    // normals. some files reference normals that don't exist (e.g. empty_cornell_box.obj)
+    bool hasNormals = normalCount > 0;
+    for (const tinyobj::shape_t& shape : shapes) {
+        for (const tinyobj::index_t& index : shape.mesh.indices) {
+            hasNormals &= index.normal_index >= 0 && static_cast<size_t>(index.normal_index) < normalCount;
+        }
+    }
+
+    ObjRange range{};
+    range.hasNormals = hasNormals;
+    range.firstVertex = arrays.vertices.size() / 4;
+    range.firstIndex = arrays.indices.size();
+
+    // OBJ indexes positions, normals and UVs separately, so every unique combination becomes one vertex. all shapes of
+    // a file share its vertices
+    std::unordered_map<std::tuple<int, int, int>, uint32_t, VertexKeyHash> uniqueVertices;
+
+    for (const tinyobj::shape_t& shape : shapes) {
+        if (shape.mesh.indices.empty()) {
+            continue;  // lines or points only
+        }
+
+        size_t shapeFirstIndex = arrays.indices.size();
+
+        for (const tinyobj::index_t& index : shape.mesh.indices) {
+            int normalIndex = hasNormals ? index.normal_index : -1;
+            int uvIndex = index.texcoord_index >= 0 && static_cast<size_t>(index.texcoord_index) < uvCount ? index.texcoord_index : -1;
+
+            auto [it, inserted] = uniqueVertices.try_emplace(
+                    std::make_tuple(index.vertex_index, normalIndex, uvIndex),
+                    static_cast<uint32_t>(arrays.vertices.size() / 4 - range.firstVertex)
+            );
+
+            if (inserted) {
+                arrays.vertices.insert(arrays.vertices.end(), {
+                        attrib.vertices[index.vertex_index * 3],
+                        attrib.vertices[index.vertex_index * 3 + 1],
+                        attrib.vertices[index.vertex_index * 3 + 2],
+                        0
+                });
+
+                if (normalIndex >= 0) {
+                    arrays.normals.insert(arrays.normals.end(), {
+                            attrib.normals[normalIndex * 3],
+                            attrib.normals[normalIndex * 3 + 1],
+                            attrib.normals[normalIndex * 3 + 2]
+                    });
+                } else {
+                    arrays.normals.insert(arrays.normals.end(), {0, 0, 0});
+                }
+
+                arrays.uvs.push_back(uvIndex >= 0 ? attrib.texcoords[uvIndex * 2] : 0);
+                arrays.uvs.push_back(uvIndex >= 0 ? attrib.texcoords[uvIndex * 2 + 1] : 0);
+            }
+
+            arrays.indices.push_back(it->second);
+        }
+
+        range.shapes.push_back({
+                shape.name,
+                shapeFirstIndex,
+                arrays.indices.size() - shapeFirstIndex
+        });
+    }
+
+    if (range.shapes.empty()) {
+        throw std::runtime_error("OBJ has no faces: " + filepath);
+    }
+
+    range.vertexCount = arrays.vertices.size() / 4 - range.firstVertex;
+    range.indexCount = arrays.indices.size() - range.firstIndex;
+
+    return range;
+}
+
+std::string reina::graphics::benchmarkObjParsers(const std::string& filepath) {
+    auto fileSize = static_cast<double>(reina::tools::MappedFile{filepath}.getSize());
+
+    auto timeParser = [&filepath](ObjRange (*parser)(const std::string&, MeshArrays&), ObjRange& range) {
+        MeshArrays arrays;
+        auto start = std::chrono::steady_clock::now();
+        range = parser(filepath, arrays);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    ObjRange tinyObjRange;
+    ObjRange streamingRange;
+    double tinyObjSeconds = timeParser(parseObjTinyObj, tinyObjRange);
+    double streamingSeconds = timeParser(parseObj, streamingRange);
+
+    double megabytes = fileSize / (1024.0 * 1024.0);
+
+    std::stringstream summary;
+    summary << filepath << " (" << megabytes << " MB, " << streamingRange.indexCount / 3 << " triangles, "
+            << streamingRange.vertexCount << " vertices, " << std::thread::hardware_concurrency() << " threads)\n";
+    summary << "  tinyobj:   " << tinyObjSeconds << " s, " << megabytes / tinyObjSeconds << " MB/s\n";
+    summary << "  streaming: " << streamingSeconds << " s, " << megabytes / streamingSeconds << " MB/s ("
+            << tinyObjSeconds / streamingSeconds << "x)\n";
+
+    if (tinyObjRange.indexCount != streamingRange.indexCount || tinyObjRange.vertexCount != streamingRange.vertexCount) {
+        summary << "  warning: the parsers disagree (tinyobj: " << tinyObjRange.indexCount / 3 << " triangles, "
+                << tinyObjRange.vertexCount << " vertices)\n";
+    }
+
+    return summary.str();
+}
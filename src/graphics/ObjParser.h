@@ -0,0 +1,58 @@
+#ifndef REINA_VK_OBJPARSER_H
+#define REINA_VK_OBJPARSER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace reina::graphics {
+    /**
+     * Geometry of all models, laid out like the combined buffers in Models. OBJ files are parsed straight into these.
+     */
+    struct MeshArrays {
+        std::vector<float> vertices;    // 4 floats per vertex, w unused
+        std::vector<uint32_t> indices;  // relative to the first vertex of their model
+        std::vector<float> normals;     // 3 floats per vertex, zero for models without (complete) normals
+        std::vector<float> uvs;         // 2 floats per vertex, zero for models without UVs
+    };
+
+    struct ObjShape {
+        std::string name;
+        size_t firstIndex;  // into MeshArrays::indices
+        size_t indexCount;
+    };
+
+    /**
+     * Where a parsed file ended up in the MeshArrays it was appended to.
+     */
+    struct ObjRange {
+        size_t firstVertex;
+        size_t vertexCount;
+        size_t firstIndex;
+        size_t indexCount;
+        bool hasNormals;  // only if every face corner references a valid normal
+        std::vector<ObjShape> shapes;  // shapes without faces are left out
+    };
+
+    /**
+     * Streaming OBJ reader. Memory maps the file, splits it into chunks at line boundaries and parses the chunks on all
+     * hardware threads, then writes vertices and triangles straight into the arrays. Positions, normals, UVs, faces
+     * (negative indices allowed) and o/g are read; everything else is skipped. Quads are split like tinyobj splits
+     * them and larger polygons are fan triangulated. usemtl and the .mtl are ignored, since materials are set per
+     * object (or per shape, through its own object) in the scene file.
+     * Throws on malformed files.
+     */
+    [[nodiscard]] ObjRange parseObj(const std::string& filepath, MeshArrays& arrays);
+
+    /**
+     * The same, through tinyobjloader. Slower, but kept as a reference for parseObj.
+     */
+    [[nodiscard]] ObjRange parseObjTinyObj(const std::string& filepath, MeshArrays& arrays);
+
+    /**
+     * Parses the file with both readers and returns their throughput, for --bench-obj.
+     */
+    [[nodiscard]] std::string benchmarkObjParsers(const std::string& filepath);
+}
+
+#endif //REINA_VK_OBJPARSER_H
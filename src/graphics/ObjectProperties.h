@@ -1,15 +1,19 @@
 #ifndef RAYGUN_VK_OBJECTPROPERTIES_H
 #define RAYGUN_VK_OBJECTPROPERTIES_H
 
+#include <cstdint>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 namespace reina::graphics {
     struct alignas(16) ObjectProperties {
-        uint32_t indicesBytesOffset;
+        uint32_t indicesBytesOffset;  // of the model's range in the indices buffer
         glm::vec3 albedo;
         glm::vec4 emission;  // xyz: emission RGB, w: emission strength
         float fuzzOrRefIdx;  // fuzz of the material if metal, refractive index if dielectric. ignored for lambertian
-        glm::vec3 padding2 = glm::vec3(0.0f);
+        uint32_t hasVertexNormals = 0;  // 1 to interpolate the normals from the attributes buffer
+        uint32_t firstVertex = 0;       // added to the model-local indices. the first sphere for sphere objects
+        uint32_t shortIndices = 0;      // 1 if the range holds 16-bit indices
     };
 }
 
@@ -0,0 +1,51 @@
+#include "RtPipeline.h"
+
+#include "Shader.h"
+
+reina::graphics::RtPipeline::RtPipeline(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const RtPipelineDescription& description)
+    : pipelineInfo(buildPipeline(logicalDevice, pipelineCache, shaderLoader, description)),
+      sbt(vktools::createSbt(logicalDevice, physicalDevice, pipelineInfo.pipeline, description.sbtSpacing, 2 + description.hitGroups.size())) {}
+
+vktools::PipelineInfo reina::graphics::RtPipeline::buildPipeline(VkDevice logicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const RtPipelineDescription& description) {
+    std::vector<Shader> shaders;
+    shaders.reserve(description.shaders.size());
+
+    try {
+        for (const RtShader& shader : description.shaders) {
+            shaders.emplace_back(logicalDevice, shaderLoader.load(shader.name), shader.stage, shader.specializationConstants);
+        }
+
+        vktools::PipelineInfo info = vktools::createRtPipeline(logicalDevice, pipelineCache, description.descriptorSet, shaders, description.hitGroups, description.pushConstants);
+
+        for (Shader& shader : shaders) {
+            shader.destroy(logicalDevice);
+        }
+
+        return info;
+    } catch (...) {
+        // a shader that fails to compile during a reload must not leak the modules of the others
+        for (Shader& shader : shaders) {
+            shader.destroy(logicalDevice);
+        }
+
+        throw;
+    }
+}
+
+VkPipeline reina::graphics::RtPipeline::getPipeline() const {
+    return pipelineInfo.pipeline;
+}
+
+VkPipelineLayout reina::graphics::RtPipeline::getLayout() const {
+    return pipelineInfo.pipelineLayout;
+}
+
+const reina::core::Buffer& reina::graphics::RtPipeline::getSbt() const {
+    return sbt;
+}
+
+void reina::graphics::RtPipeline::destroy(VkDevice logicalDevice) {
+    sbt.destroy(logicalDevice);
+    vkDestroyPipeline(logicalDevice, pipelineInfo.pipeline, nullptr);
+    vkDestroyPipelineLayout(logicalDevice, pipelineInfo.pipelineLayout, nullptr);
+}
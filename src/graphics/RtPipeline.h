@@ -0,0 +1,56 @@
+#ifndef REINA_VK_RTPIPELINE_H
+#define REINA_VK_RTPIPELINE_H
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+#include "../tools/vktools.h"
+#include "../core/Buffer.h"
+#include "../core/DescriptorSet.h"
+#include "../core/PushConstants.h"
+#include "ShaderLoader.h"
+
+namespace reina::graphics {
+    struct RtShader {
+        std::string name;  // for ShaderLoader
+        VkShaderStageFlagBits stage;
+        std::vector<uint32_t> specializationConstants = {};  // by constant_id, see Shader
+    };
+
+    /**
+     * Everything needed to build the ray tracing pipeline, apart from the shader code: the shaders in the order
+     * vktools::createRtPipeline expects them (raygen, miss, then the hit group shaders), the hit groups, and the
+     * layout objects. All of it is fixed after startup, so the pipeline can be rebuilt from it on any thread.
+     */
+    struct RtPipelineDescription {
+        std::vector<RtShader> shaders;
+        std::vector<vktools::HitGroup> hitGroups;
+        const reina::core::DescriptorSet& descriptorSet;
+        const reina::core::PushConstants& pushConstants;
+        vktools::SbtSpacing sbtSpacing;
+    };
+
+    /**
+     * The ray tracing pipeline together with its shader binding table.
+     */
+    class RtPipeline {
+    public:
+        RtPipeline(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const RtPipelineDescription& description);
+
+        [[nodiscard]] VkPipeline getPipeline() const;
+        [[nodiscard]] VkPipelineLayout getLayout() const;
+        [[nodiscard]] const reina::core::Buffer& getSbt() const;
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        vktools::PipelineInfo pipelineInfo;
+        reina::core::Buffer sbt;
+
+        static vktools::PipelineInfo buildPipeline(VkDevice logicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const RtPipelineDescription& description);
+    };
+}
+
+#endif //REINA_VK_RTPIPELINE_H
@@ -0,0 +1,152 @@
+#include "SampleScheduler.h"
+
+#include <algorithm>
+
+#include "../../polyglot/common.h"
+
+namespace {
+    constexpr uint32_t MAX_SAMPLES_PER_DISPATCH = 4 * SAMPLES_PER_PIXEL;
+    constexpr uint32_t MIN_ROWS_PER_BAND = 16;  // smaller dispatches don't fill the GPU anyway
+    constexpr double THROUGHPUT_SMOOTHING = 0.3;  // weight of the newest measurement
+
+    constexpr uint32_t PREVIEW_BOUNCES = 3;  // direct light and a bit of indirect, enough to judge the view
+    constexpr uint32_t MAX_PREVIEW_SCALE = 16;
+    constexpr double UNLIMITED_PREVIEW_BUDGET = 1.0 / 60;  // seconds, the preview aims for this without a frame budget
+
+    uint32_t ceilDivide(uint32_t value, uint32_t divisor) {
+        return (value + divisor - 1) / divisor;
+    }
+
+    double smoothThroughput(double estimate, double measured) {
+        return estimate == 0 ? measured : estimate + THROUGHPUT_SMOOTHING * (measured - estimate);
+    }
+}
+
+reina::graphics::SampleScheduler::SampleScheduler(uint32_t width, uint32_t height, double frameBudget, bool splitRows, uint32_t targetSamples)
+    : width(width), height(height), frameBudget(frameBudget), splitRows(splitRows), targetSamples(targetSamples) {}
+
+reina::graphics::SamplePlan reina::graphics::SampleScheduler::next() {
+    if (nextRow == 0) {
+        passSamplesPerPixel = choosePassSamplesPerPixel();
+
+        // land exactly on the target
+        if (targetSamples > 0) {
+            passSamplesPerPixel = std::min(passSamplesPerPixel, targetSamples - std::min(accumulatedSamples, targetSamples - 1));
+        }
+    }
+
+    uint32_t rowCount = height - nextRow;
+    if (frameBudget > 0 && splitRows && passSamplesPerPixel == 1 && pixelSamplesPerSecond > 0) {
+        double budgetRows = pixelSamplesPerSecond * frameBudget / width;
+        rowCount = static_cast<uint32_t>(std::clamp(budgetRows, static_cast<double>(std::min(MIN_ROWS_PER_BAND, rowCount)), static_cast<double>(rowCount)));
+    }
+
+    SamplePlan plan{passSamplesPerPixel, accumulatedSamples, sampleBatch, nextRow, rowCount, BOUNCES_PER_SAMPLE, 1};
+    lastPixelSamples = static_cast<uint64_t>(width) * rowCount * passSamplesPerPixel;
+    lastWasPreview = false;
+
+    nextRow += rowCount;
+    if (nextRow >= height) {
+        nextRow = 0;
+        accumulatedSamples += passSamplesPerPixel;
+        sampleBatch++;
+    }
+
+    return plan;
+}
+
+reina::graphics::SamplePlan reina::graphics::SampleScheduler::nextPreview() {
+    uint32_t scale = choosePreviewScale();
+
+    // the same batch every frame keeps the noise from crawling over a moving image
+    SamplePlan plan{1, 0, 0, 0, height, PREVIEW_BOUNCES, scale};
+    lastPixelSamples = static_cast<uint64_t>(ceilDivide(width, scale)) * ceilDivide(height, scale);
+    lastWasPreview = true;
+
+    return plan;
+}
+
+void reina::graphics::SampleScheduler::reportTime(double seconds, uint64_t pixelSamples) {
+    if (seconds <= 0 || pixelSamples == 0) {
+        return;
+    }
+
+    double measured = static_cast<double>(pixelSamples) / seconds;
+    if (lastWasPreview) {
+        previewPixelSamplesPerSecond = smoothThroughput(previewPixelSamplesPerSecond, measured);
+    } else {
+        pixelSamplesPerSecond = smoothThroughput(pixelSamplesPerSecond, measured);
+    }
+}
+
+void reina::graphics::SampleScheduler::reset() {
+    accumulatedSamples = 0;
+    sampleBatch = 0;
+    nextRow = 0;
+    converged = false;
+}
+
+void reina::graphics::SampleScheduler::reproject() {
+    if (nextRow != 0) {
+        sampleBatch++;  // the interrupted pass already used its batch in some rows
+    }
+
+    accumulatedSamples = 0;
+    nextRow = 0;
+    converged = false;
+}
+
+bool reina::graphics::SampleScheduler::fitsFullPass() const {
+    return frameBudget <= 0 || pixelSamplesPerSecond * frameBudget >= static_cast<double>(width) * height;
+}
+
+void reina::graphics::SampleScheduler::markConverged() {
+    // what converged was the image from before a reset
+    if (accumulatedSamples > 0) {
+        converged = true;
+    }
+}
+
+bool reina::graphics::SampleScheduler::isFinished() const {
+    return converged || (targetSamples > 0 && accumulatedSamples >= targetSamples);
+}
+
+uint32_t reina::graphics::SampleScheduler::getAccumulatedSamples() const {
+    return accumulatedSamples;
+}
+
+uint64_t reina::graphics::SampleScheduler::getLastPixelSamples() const {
+    return lastPixelSamples;
+}
+
+uint32_t reina::graphics::SampleScheduler::choosePassSamplesPerPixel() const {
+    if (frameBudget <= 0) {
+        return SAMPLES_PER_PIXEL;
+    }
+
+    // the first frame has nothing to go by, so it starts with the least work
+    if (pixelSamplesPerSecond == 0) {
+        return 1;
+    }
+
+    double fitting = pixelSamplesPerSecond * frameBudget / (static_cast<double>(width) * height);
+    return static_cast<uint32_t>(std::clamp(fitting, 1.0, static_cast<double>(MAX_SAMPLES_PER_DISPATCH)));
+}
+
+uint32_t reina::graphics::SampleScheduler::choosePreviewScale() const {
+    // the first preview has nothing to go by, so it starts coarse
+    if (previewPixelSamplesPerSecond == 0) {
+        return MAX_PREVIEW_SCALE / 2;
+    }
+
+    double budget = frameBudget > 0 ? frameBudget : UNLIMITED_PREVIEW_BUDGET;
+    double fittingPixels = previewPixelSamplesPerSecond * budget;
+
+    uint32_t scale = 1;
+    while (scale < MAX_PREVIEW_SCALE
+           && static_cast<double>(ceilDivide(width, scale)) * ceilDivide(height, scale) > fittingPixels) {
+        scale *= 2;
+    }
+
+    return scale;
+}
@@ -0,0 +1,112 @@
+#ifndef REINA_VK_SAMPLESCHEDULER_H
+#define REINA_VK_SAMPLESCHEDULER_H
+
+#include <cstdint>
+
+namespace reina::graphics {
+    /**
+     * The work of one frame: a band of rows, traced with the same number of samples per pixel.
+     */
+    struct SamplePlan {
+        uint32_t samplesPerPixel;
+        uint32_t accumulatedSamples;  // per pixel, already in the image before this dispatch
+        uint32_t sampleBatch;         // index of the pass over the image since the last reset, seeds the RNG
+        uint32_t firstRow;
+        uint32_t rowCount;
+        uint32_t bounces;       // per sample
+        uint32_t previewScale;  // 1 at full resolution, otherwise one sample per block of previewScale² pixels
+    };
+
+    /**
+     * Decides how many samples each frame traces, so that frames take about as long as the frame budget no matter
+     * what the scene costs. The throughput is estimated from the GPU time of previous frames:
+     *  - if the budget fits at least one sample of the whole image, every frame traces the whole image with as many
+     *    samples per pixel as fit
+     *  - otherwise a pass of one sample per pixel is split into bands of rows, traced over several frames. Pixels of a
+     *    pass that weren't traced yet keep showing the previous pass
+     * Without a budget every frame traces SAMPLES_PER_PIXEL over the whole image, which keeps offline renders and the
+     * benchmark deterministic.
+     *
+     * While the camera moves, previews replace the passes: one sample per block of pixels with a few bounces, not
+     * accumulated, with the blocks as small as the budget allows. Once it stops, a reset starts the full quality image,
+     * whose first passes overwrite the last preview.
+     *
+     * Once the image is finished, i.e. it has the target samples per pixel or adaptive sampling found every pixel
+     * converged, nothing should be traced until the next reset.
+     */
+    class SampleScheduler {
+    public:
+        /**
+         * @param frameBudget GPU seconds per frame to aim for, 0 for unlimited
+         * @param splitRows if passes may be split into bands. The wavefront integrator always traces the whole image
+         * @param targetSamples samples per pixel at which the image is finished, 0 for never
+         */
+        SampleScheduler(uint32_t width, uint32_t height, double frameBudget, bool splitRows, uint32_t targetSamples);
+
+        /**
+         * Plans the next frame and assumes it will be traced.
+         */
+        [[nodiscard]] SamplePlan next();
+
+        /**
+         * Plans a preview frame. It doesn't count towards the image, so the next full quality frame should follow a reset.
+         */
+        [[nodiscard]] SamplePlan nextPreview();
+
+        /**
+         * Updates the throughput estimate with the measured GPU time of the last planned frame.
+         * @param pixelSamples what the frame actually traced, which is less than planned when adaptive sampling only
+         * traced the pixels on its work list
+         */
+        void reportTime(double seconds, uint64_t pixelSamples);
+
+        /**
+         * Starts the image over, e.g. after the camera moved.
+         */
+        void reset();
+
+        /**
+         * Starts the image over like reset, for when the image keeps its samples through temporal reprojection. The
+         * sample batches continue, so the new samples aren't correlated with the reprojected ones.
+         */
+        void reproject();
+
+        /**
+         * If a pass of one sample over the whole image fits the budget, as far as measured yet.
+         */
+        [[nodiscard]] bool fitsFullPass() const;
+
+        /**
+         * Finishes the image before the target samples, for when there is nothing left worth tracing.
+         */
+        void markConverged();
+        [[nodiscard]] bool isFinished() const;
+
+        // per pixel, once everything planned so far has been traced
+        [[nodiscard]] uint32_t getAccumulatedSamples() const;
+        [[nodiscard]] uint64_t getLastPixelSamples() const;
+
+    private:
+        uint32_t width;
+        uint32_t height;
+        double frameBudget;
+        bool splitRows;
+        uint32_t targetSamples;
+        bool converged = false;
+
+        double pixelSamplesPerSecond = 0;  // 0 until the first frame was measured
+        double previewPixelSamplesPerSecond = 0;  // separate, since preview samples have fewer bounces
+        uint64_t lastPixelSamples = 0;
+        bool lastWasPreview = false;
+
+        uint32_t accumulatedSamples = 0;
+        uint32_t sampleBatch = 0;
+        uint32_t passSamplesPerPixel = 0;
+        uint32_t nextRow = 0;  // a pass is in progress if this isn't 0
+
+        [[nodiscard]] uint32_t choosePassSamplesPerPixel() const;
+        [[nodiscard]] uint32_t choosePreviewScale() const;
+    };
+}
+
+#endif //REINA_VK_SAMPLESCHEDULER_H
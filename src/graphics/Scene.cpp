@@ -0,0 +1,267 @@
+#include "Scene.h"
+
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+reina::graphics::Scene::Scene(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const std::string& filepath, bool optimizeMeshes) {
+    reina::tools::JsonValue root = reina::tools::readJsonFile(filepath);
+    std::filesystem::path sceneDirectory = std::filesystem::path(filepath).parent_path();
+
+    const reina::tools::JsonValue& cameraJson = root["camera"];
+    camera = {
+            parseVec3(cameraJson["position"]),
+            glm::normalize(parseVec3(cameraJson["direction"])),
+            cameraJson["fov"].asFloat()
+    };
+
+    const reina::tools::JsonValue::Array& objects = root["objects"].asArray();
+
+    // Models stores identical meshes once and the registry builds one BLAS for each, so objects can list meshes freely.
+    // sphere objects instead get a range of the spheres buffer each
+    std::vector<std::string> meshPaths;
+    std::vector<int> modelIndices(objects.size(), -1);
+    std::vector<glm::vec4> spheres;
+    std::vector<VkAabbPositionsKHR> sphereAabbs;
+    std::vector<std::pair<uint32_t, uint32_t>> sphereRanges(objects.size());  // first sphere and count
+
+    for (size_t i = 0; i < objects.size(); i++) {
+        if (objects[i].contains("spheres")) {
+            sphereRanges[i].first = static_cast<uint32_t>(spheres.size());
+
+            for (const reina::tools::JsonValue& sphereJson : objects[i]["spheres"].asArray()) {
+                glm::vec4 sphere = parseSphere(sphereJson);
+                spheres.push_back(sphere);
+                sphereAabbs.push_back(VkAabbPositionsKHR{
+                        sphere.x - sphere.w, sphere.y - sphere.w, sphere.z - sphere.w,
+                        sphere.x + sphere.w, sphere.y + sphere.w, sphere.z + sphere.w
+                });
+            }
+
+            sphereRanges[i].second = static_cast<uint32_t>(spheres.size()) - sphereRanges[i].first;
+            if (sphereRanges[i].second == 0) {
+                throw std::runtime_error("Sphere object without spheres in the scene file");
+            }
+        } else {
+            modelIndices[i] = static_cast<int>(meshPaths.size());
+            meshPaths.push_back((sceneDirectory / objects[i]["mesh"].asString()).lexically_normal().string());
+        }
+    }
+
+    // the hit shaders' vertex, index and attribute bindings need buffers
+    if (meshPaths.empty()) {
+        throw std::runtime_error("A scene needs at least one mesh object");
+    }
+
+    models.emplace(logicalDevice, physicalDevice, meshPaths, optimizeMeshes);
+    meshRegistry.emplace(logicalDevice, physicalDevice, cmdPool, queue, models.value());
+
+    // never empty, so binding 6 always has a buffer
+    if (spheres.empty()) {
+        spheres.emplace_back(0.0f);
+    }
+
+    spheresBuffer = reina::core::Buffer{
+            logicalDevice, physicalDevice, spheres,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            static_cast<VkMemoryAllocateFlags>(0),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    };
+
+    if (!sphereAabbs.empty()) {
+        sphereAabbsBuffer = reina::core::Buffer{
+                logicalDevice, physicalDevice, sphereAabbs,
+                VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        };
+    }
+
+    std::vector<ObjectProperties> objectProperties;
+    objectProperties.reserve(objects.size());
+    instances.reserve(objects.size());
+
+    for (size_t i = 0; i < objects.size(); i++) {
+        const reina::tools::JsonValue& object = objects[i];
+
+        Material material = object.contains("material") ? parseMaterial(object["material"].asString()) : Material::Lambertian;
+        glm::vec3 albedo = object.contains("albedo") ? parseVec3(object["albedo"]) : glm::vec3(0.8f);
+        glm::vec4 emission = object.contains("emission")
+                ? glm::vec4(parseVec3(object["emission"]), object.contains("emissionStrength") ? object["emissionStrength"].asFloat() : 1.0f)
+                : glm::vec4(0.0f);
+        glm::mat4 transform = object.contains("transform") ? parseTransform(object["transform"]) : glm::mat4(1.0f);
+
+        float fuzzOrRefIdx = 0;
+        if (material == Material::Metal && object.contains("fuzz")) {
+            fuzzOrRefIdx = object["fuzz"].asFloat();
+        } else if (material == Material::Dielectric) {
+            fuzzOrRefIdx = object.contains("refractiveIndex") ? object["refractiveIndex"].asFloat() : 1.5f;
+        }
+
+        if (modelIndices[i] < 0) {
+            auto [firstSphere, sphereCount] = sphereRanges[i];
+            VkDevice device = logicalDevice;
+            std::shared_ptr<const Blas> blas(
+                    new Blas{logicalDevice, physicalDevice, cmdPool, queue, sphereAabbsBuffer.value(), firstSphere, sphereCount},
+                    [device](Blas* expired) {
+                        expired->destroy(device);
+                        delete expired;
+                    }
+            );
+
+            uint32_t hitGroup = SPHERE_HIT_GROUPS_OFFSET + static_cast<uint32_t>(material);
+            instances.push_back(Instance{blas, static_cast<uint32_t>(i), hitGroup, transform});
+            objectProperties.push_back(ObjectProperties{0, albedo, emission, fuzzOrRefIdx, 0, firstSphere, 0});
+            continue;
+        }
+
+        int modelIndex = modelIndices[i];
+        int shapeIndex = object.contains("shape") ? findShape(models.value(), modelIndex, object["shape"].asString()) : -1;
+        SharedMesh mesh = meshRegistry->acquire(modelIndex, shapeIndex);
+
+        glm::mat4 blasTransform = transform * models->getDequantizeTransform(modelIndex);
+        instances.push_back(Instance{mesh.blas, static_cast<uint32_t>(i), static_cast<uint32_t>(material), blasTransform});
+        uint32_t hasVertexNormals = models->hasVertexNormals(modelIndex) ? 1 : 0;
+        uint32_t shortIndices = mesh.range.indexType == VK_INDEX_TYPE_UINT16 ? 1 : 0;
+        objectProperties.push_back(ObjectProperties{
+                mesh.range.indexOffset, albedo, emission, fuzzOrRefIdx, hasVertexNormals, mesh.range.firstVertex, shortIndices
+        });
+    }
+
+    tlas = vktools::createTlas(logicalDevice, physicalDevice, cmdPool, queue, instances);
+
+    objectPropertiesBuffer = reina::core::Buffer{
+            logicalDevice, physicalDevice, objectProperties,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            static_cast<VkMemoryAllocateFlags>(0),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+    };
+}
+
+glm::vec3 reina::graphics::Scene::parseVec3(const reina::tools::JsonValue& value) {
+    if (value.isNumber()) {
+        return glm::vec3(value.asFloat());
+    }
+
+    if (value.size() != 3) {
+        throw std::runtime_error("Expected a vec3 in the scene file");
+    }
+
+    return {value[0].asFloat(), value[1].asFloat(), value[2].asFloat()};
+}
+
+glm::vec4 reina::graphics::Scene::parseSphere(const reina::tools::JsonValue& value) {
+    // [x, y, z, radius] in object space
+    if (value.size() != 4 || value[3].asFloat() <= 0) {
+        throw std::runtime_error("Expected a sphere as [x, y, z, radius] with a positive radius in the scene file");
+    }
+
+    return {value[0].asFloat(), value[1].asFloat(), value[2].asFloat(), value[3].asFloat()};
+}
+
+glm::mat4 reina::graphics::Scene::parseTransform(const reina::tools::JsonValue& transform) {
+    // a list of operations, applied in the same order as chaining the glm calls
+    glm::mat4 result(1.0f);
+
+    for (const reina::tools::JsonValue& operation : transform.asArray()) {
+        if (operation.contains("translate")) {
+            result = glm::translate(result, parseVec3(operation["translate"]));
+        } else if (operation.contains("scale")) {
+            result = glm::scale(result, parseVec3(operation["scale"]));
+        } else if (operation.contains("rotate")) {
+            result = glm::rotate(result, glm::radians(operation["rotate"].asFloat()), parseVec3(operation["axis"]));
+        } else {
+            throw std::runtime_error("Unknown transform operation in the scene file");
+        }
+    }
+
+    return result;
+}
+
+int reina::graphics::Scene::findShape(const Models& models, int modelIndex, const std::string& name) {
+    const std::vector<ShapeRange>& shapes = models.getShapeRanges(modelIndex);
+
+    for (int i = 0; i < shapes.size(); i++) {
+        if (shapes[i].name == name) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Unknown shape in the scene file: " + name);
+}
+
+reina::graphics::Material reina::graphics::Scene::parseMaterial(const std::string& name) {
+    if (name == "lambertian") {
+        return Material::Lambertian;
+    } else if (name == "metal") {
+        return Material::Metal;
+    } else if (name == "dielectric") {
+        return Material::Dielectric;
+    }
+
+    throw std::runtime_error("Unknown material in the scene file: " + name);
+}
+
+const reina::graphics::CameraSettings& reina::graphics::Scene::getCamera() const {
+    return camera;
+}
+
+const reina::graphics::Models& reina::graphics::Scene::getModels() const {
+    return models.value();
+}
+
+const reina::graphics::MeshRegistry& reina::graphics::Scene::getMeshRegistry() const {
+    return meshRegistry.value();
+}
+
+const std::vector<reina::graphics::Instance>& reina::graphics::Scene::getInstances() const {
+    return instances;
+}
+
+const VkAccelerationStructureKHR& reina::graphics::Scene::getTlas() const {
+    return tlas.value().accelerationStructure;
+}
+
+const reina::core::Buffer& reina::graphics::Scene::getObjectPropertiesBuffer() const {
+    return objectPropertiesBuffer.value();
+}
+
+const reina::core::Buffer& reina::graphics::Scene::getSpheresBuffer() const {
+    return spheresBuffer.value();
+}
+
+void reina::graphics::Scene::destroy(VkDevice logicalDevice) {
+    auto vkDestroyAccelerationStructureKHR = reinterpret_cast<PFN_vkDestroyAccelerationStructureKHR>(
+            vkGetDeviceProcAddr(logicalDevice, "vkDestroyAccelerationStructureKHR"));
+
+    if (!vkDestroyAccelerationStructureKHR) {
+        throw std::runtime_error("Destroy acceleration structure function cannot be found");
+    }
+
+    if (tlas.has_value()) {
+        vkDestroyAccelerationStructureKHR(logicalDevice, tlas.value().accelerationStructure, nullptr);
+        tlas.value().buffer.destroy(logicalDevice);
+    }
+
+    // the BLASes are destroyed with their last instance
+    instances.clear();
+
+    if (objectPropertiesBuffer.has_value()) {
+        objectPropertiesBuffer.value().destroy(logicalDevice);
+    }
+
+    if (spheresBuffer.has_value()) {
+        spheresBuffer.value().destroy(logicalDevice);
+    }
+
+    if (sphereAabbsBuffer.has_value()) {
+        sphereAabbsBuffer.value().destroy(logicalDevice);
+    }
+
+    if (models.has_value()) {
+        models.value().destroy(logicalDevice);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef REINA_VK_SCENE_H
+#define REINA_VK_SCENE_H
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Models.h"
+#include "Instance.h"
+#include "MeshRegistry.h"
+#include "ObjectProperties.h"
+#include "../core/Buffer.h"
+#include "../tools/Json.h"
+#include "../tools/vktools.h"
+#include "../../polyglot/common.h"
+
+namespace reina::graphics {
+    /**
+     * Hit group offsets in the shader binding table. Must match the order of the closest hit shaders passed to
+     * vktools::createRtPipeline.
+     */
+    enum class Material : uint32_t {
+        Lambertian = 0,
+        Metal = 1,
+        Dielectric = 2
+    };
+
+    /**
+     * The hit groups of sphere objects follow the triangle ones, in the same material order.
+     */
+    constexpr uint32_t SPHERE_HIT_GROUPS_OFFSET = MATERIAL_COUNT;
+
+    struct CameraSettings {
+        glm::vec3 position;
+        glm::vec3 direction;
+        float fov;  // vertical, in degrees
+    };
+
+    /**
+     * A scene loaded from a JSON scene file (see scenes/demo.json). Builds the models, one BLAS per unique mesh, the
+     * TLAS and the object properties buffer. Objects with the same geometry are instances of one BLAS (see MeshRegistry),
+     * so instancing a mesh costs a TLAS instance and an ObjectProperties entry rather than another copy of the geometry.
+     * Mesh paths are relative to the scene file. Objects with "spheres" instead of "mesh" are analytic spheres: a few
+     * bytes each in an AABB BLAS, intersected by sphere.rint.glsl. The scene must not be moved once constructed.
+     */
+    class Scene {
+    public:
+        Scene(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const std::string& filepath, bool optimizeMeshes = true);
+
+        [[nodiscard]] const CameraSettings& getCamera() const;
+        [[nodiscard]] const Models& getModels() const;
+        [[nodiscard]] const MeshRegistry& getMeshRegistry() const;
+        [[nodiscard]] const std::vector<Instance>& getInstances() const;
+        [[nodiscard]] const VkAccelerationStructureKHR& getTlas() const;
+        [[nodiscard]] const reina::core::Buffer& getObjectPropertiesBuffer() const;
+        [[nodiscard]] const reina::core::Buffer& getSpheresBuffer() const;  // vec4 per sphere: center and radius
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        [[nodiscard]] static glm::vec3 parseVec3(const reina::tools::JsonValue& value);
+        [[nodiscard]] static glm::vec4 parseSphere(const reina::tools::JsonValue& value);
+        [[nodiscard]] static glm::mat4 parseTransform(const reina::tools::JsonValue& transform);
+        [[nodiscard]] static Material parseMaterial(const std::string& name);
+        [[nodiscard]] static int findShape(const Models& models, int modelIndex, const std::string& name);
+
+        CameraSettings camera{};
+        std::optional<Models> models;
+        std::optional<MeshRegistry> meshRegistry;
+        std::vector<Instance> instances;
+        std::optional<vktools::AccStructureInfo> tlas;
+        std::optional<reina::core::Buffer> objectPropertiesBuffer;
+        std::optional<reina::core::Buffer> spheresBuffer;
+        std::optional<reina::core::Buffer> sphereAabbsBuffer;
+    };
+}
+
+#endif //REINA_VK_SCENE_H
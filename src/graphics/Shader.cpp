@@ -1,50 +1,48 @@
 #include "Shader.h"
 
 #include <stdexcept>
-#include <fstream>
-#include <iostream>
 #include <utility>
 
-reina::graphics::Shader::Shader(VkDevice logicalDevice, const std::string& path, VkShaderStageFlagBits shaderStage, std::string  entryPoint)
+reina::graphics::Shader::Shader(VkDevice logicalDevice, const std::vector<uint32_t>& code, VkShaderStageFlagBits shaderStage, std::string  entryPoint)
     : shaderStage(shaderStage), entryPoint(std::move(entryPoint)) {
-    shaderModule = createShaderModule(logicalDevice, readFile(path));
+    shaderModule = createShaderModule(logicalDevice, code);
+}
+
+reina::graphics::Shader::Shader(VkDevice logicalDevice, const std::vector<uint32_t>& code, VkShaderStageFlagBits shaderStage, std::vector<uint32_t> specializationConstants)
+    : Shader(logicalDevice, code, shaderStage) {
+    this->specializationConstants = std::move(specializationConstants);
+    for (uint32_t i = 0; i < this->specializationConstants.size(); i++) {
+        specializationEntries.push_back(VkSpecializationMapEntry{
+            .constantID = i,
+            .offset = i * static_cast<uint32_t>(sizeof(uint32_t)),
+            .size = sizeof(uint32_t)
+        });
+    }
 }
 
 VkPipelineShaderStageCreateInfo reina::graphics::Shader::pipelineShaderStageCreateInfo() const {
+    // rebuilt on every call, so it is valid for a moved shader too
+    specializationInfo = VkSpecializationInfo{
+        .mapEntryCount = static_cast<uint32_t>(specializationEntries.size()),
+        .pMapEntries = specializationEntries.data(),
+        .dataSize = specializationConstants.size() * sizeof(uint32_t),
+        .pData = specializationConstants.data()
+    };
+
     return VkPipelineShaderStageCreateInfo{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
         .stage = shaderStage,
         .module = shaderModule,
-        .pName = entryPoint.c_str()
+        .pName = entryPoint.c_str(),
+        .pSpecializationInfo = specializationConstants.empty() ? nullptr : &specializationInfo
     };
 }
 
-std::vector<char> reina::graphics::Shader::readFile(const std::string &filepath) {
-    // std::ios::ate - start at the end of the file
-    std::ifstream file(filepath, std::ios::ate | std::ios::binary);
-
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open shader file at path: " + filepath);
-    }
-
-    // use the current pos to tell the size and allocate a buffer
-    auto fileSize = (size_t) file.tellg();
-    std::vector<char> buffer(fileSize);
-
-    // go to the beginning and read allat
-    file.seekg(0);
-    file.read(buffer.data(), static_cast<std::streamsize>(fileSize));
-
-    file.close();
-
-    return buffer;
-}
-
-VkShaderModule reina::graphics::Shader::createShaderModule(VkDevice logicalDevice, const std::vector<char>& code) {
+VkShaderModule reina::graphics::Shader::createShaderModule(VkDevice logicalDevice, const std::vector<uint32_t>& code) {
     VkShaderModuleCreateInfo createInfo{
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = code.size(),
-        .pCode = reinterpret_cast<const uint32_t*>(code.data())
+        .codeSize = code.size() * sizeof(uint32_t),
+        .pCode = code.data()
     };
 
     VkShaderModule shaderModule;
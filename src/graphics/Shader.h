@@ -2,6 +2,7 @@
 #define RAYGUN_VK_SHADER_H
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -9,7 +10,13 @@
 namespace reina::graphics {
     class Shader {
     public:
-        Shader(VkDevice logicalDevice, const std::string& path, VkShaderStageFlagBits shaderStage, std::string entryPoint = "main");
+        Shader(VkDevice logicalDevice, const std::vector<uint32_t>& code, VkShaderStageFlagBits shaderStage, std::string entryPoint = "main");
+
+        /**
+         * With specialization constants, where the value at index i is the one of constant_id i. The driver compiles
+         * the pipeline with them folded in, so branches on them cost nothing.
+         */
+        Shader(VkDevice logicalDevice, const std::vector<uint32_t>& code, VkShaderStageFlagBits shaderStage, std::vector<uint32_t> specializationConstants);
 
         void destroy(VkDevice logicalDevice);
 
@@ -20,8 +27,11 @@ namespace reina::graphics {
         VkShaderStageFlagBits shaderStage;
         std::string entryPoint;
 
-        static std::vector<char> readFile(const std::string& filepath);
-        static VkShaderModule createShaderModule(VkDevice logicalDevice, const std::vector<char>& code);
+        std::vector<uint32_t> specializationConstants;
+        std::vector<VkSpecializationMapEntry> specializationEntries;
+        mutable VkSpecializationInfo specializationInfo{};  // points into the vectors above, filled when it is used
+
+        static VkShaderModule createShaderModule(VkDevice logicalDevice, const std::vector<uint32_t>& code);
     };
 }
 
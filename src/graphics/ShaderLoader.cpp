@@ -0,0 +1,167 @@
+#include "ShaderLoader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifndef REINA_GLSLC
+#define REINA_GLSLC "glslc"
+#endif
+
+namespace {
+    constexpr std::string_view TARGET_ENV = "vulkan1.3";  // same as the build, see reina_add_shader
+
+    void hashBytes(uint64_t& hash, std::string_view bytes) {
+        // FNV-1a, like the mesh content hashes. the length is mixed in too, so concatenated fields can't alias
+        for (char byte : bytes) {
+            hash = (hash ^ static_cast<unsigned char>(byte)) * 1099511628211ull;
+        }
+
+        hash = (hash ^ bytes.size()) * 1099511628211ull;
+    }
+
+    // hashes the file and, depth first, every file it #includes, each once. a missing file is hashed by name only,
+    // glslc reports it when compiling
+    void hashSourceTree(uint64_t& hash, const std::filesystem::path& filepath, std::set<std::filesystem::path>& visited) {
+        std::filesystem::path normalized = filepath.lexically_normal();
+        if (!visited.insert(normalized).second) {
+            return;
+        }
+
+        hashBytes(hash, normalized.filename().string());
+
+        std::ifstream file(normalized, std::ios::binary);
+        if (!file) {
+            return;
+        }
+
+        std::string source{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        hashBytes(hash, source);
+
+        static const std::regex includePattern(R"re(^[ \t]*#[ \t]*include[ \t]*"([^"]+)")re", std::regex::multiline);
+        for (auto it = std::sregex_iterator(source.begin(), source.end(), includePattern); it != std::sregex_iterator(); ++it) {
+            hashSourceTree(hash, normalized.parent_path() / (*it)[1].str(), visited);
+        }
+    }
+
+    /**
+     * Quotes an argument for std::system. cmd.exe only knows double quotes (which paths can't contain there), a POSIX
+     * shell would still expand $ and ` inside them, so it gets single quotes with embedded ones escaped.
+     */
+    std::string quote(const std::string& argument) {
+#ifdef _WIN32
+        return "\"" + argument + "\"";
+#else
+        std::string quoted = "'";
+        for (char c : argument) {
+            quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+        }
+        return quoted + "'";
+#endif
+    }
+}
+
+reina::graphics::ShaderLoader::ShaderLoader(std::string sourceDirectory, std::string cacheDirectory)
+    : sourceDirectory(std::move(sourceDirectory)), cacheDirectory(std::move(cacheDirectory)) {
+    std::filesystem::create_directories(this->cacheDirectory);
+}
+
+std::vector<uint32_t> reina::graphics::ShaderLoader::load(std::string_view name) const {
+    const EmbeddedShader& shader = find(name);
+
+    if (!isCompilingAtRuntime()) {
+        return {shader.code, shader.code + shader.wordCount};
+    }
+
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(getSourceHash(name)));
+    std::string cachedPath = (std::filesystem::path(cacheDirectory) / (std::string(name) + "-" + hash + ".spv")).string();
+
+    if (std::filesystem::exists(cachedPath)) {
+        return readSpirv(cachedPath);
+    }
+
+    return compile(shader, cachedPath);
+}
+
+bool reina::graphics::ShaderLoader::isCompilingAtRuntime() const {
+    return !sourceDirectory.empty();
+}
+
+uint64_t reina::graphics::ShaderLoader::getSourceHash(std::string_view name) const {
+    const EmbeddedShader& shader = find(name);
+
+    uint64_t hash = 14695981039346656037ull;
+    hashBytes(hash, shader.stage);
+    hashBytes(hash, shader.defines);
+    hashBytes(hash, TARGET_ENV);
+
+    std::set<std::filesystem::path> visited;
+    hashSourceTree(hash, std::filesystem::path(sourceDirectory) / shader.source, visited);
+
+    return hash;
+}
+
+std::vector<uint32_t> reina::graphics::ShaderLoader::compile(const EmbeddedShader& shader, const std::string& outputPath) const {
+    std::ostringstream command;
+    command << quote(REINA_GLSLC) << " -fshader-stage=" << shader.stage << " --target-env=" << TARGET_ENV;
+
+    std::istringstream defines{std::string(shader.defines)};
+    for (std::string define; defines >> define;) {
+        command << " -D" << define;
+    }
+
+    // compiled to a temporary file, so a failed or interrupted compile never leaves a broken cache entry
+    std::string temporaryPath = outputPath + ".tmp";
+    command << " -o " << quote(temporaryPath) << " " << quote((std::filesystem::path(sourceDirectory) / shader.source).string());
+
+#ifdef _WIN32
+    // cmd /c strips the first and last quote of a command that starts with one, so the whole command gets an extra pair
+    std::string shellCommand = "\"" + command.str() + "\"";
+#else
+    std::string shellCommand = command.str();
+#endif
+
+    if (std::system(shellCommand.c_str()) != 0) {
+        std::filesystem::remove(temporaryPath);
+        throw std::runtime_error("Failed to compile shader " + std::string(shader.name) + ": " + command.str());
+    }
+
+    std::filesystem::rename(temporaryPath, outputPath);
+    return readSpirv(outputPath);
+}
+
+const reina::graphics::EmbeddedShader& reina::graphics::ShaderLoader::find(std::string_view name) {
+    for (const EmbeddedShader& shader : getEmbeddedShaders()) {
+        if (shader.name == name) {
+            return shader;
+        }
+    }
+
+    throw std::runtime_error("Unknown shader: " + std::string(name) + ". Shaders are added in CMakeLists.txt");
+}
+
+std::vector<uint32_t> reina::graphics::ShaderLoader::readSpirv(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open shader file at path: " + filepath);
+    }
+
+    auto fileSize = static_cast<size_t>(file.tellg());
+    if (fileSize == 0 || fileSize % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("Not a SPIR-V file: " + filepath);
+    }
+
+    std::vector<uint32_t> code(fileSize / sizeof(uint32_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(code.data()), static_cast<std::streamsize>(fileSize));
+
+    return code;
+}
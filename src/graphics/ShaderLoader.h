@@ -0,0 +1,54 @@
+#ifndef REINA_VK_SHADERLOADER_H
+#define REINA_VK_SHADERLOADER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EmbeddedShaders.h"
+
+namespace reina::graphics {
+    /**
+     * Hands out SPIR-V by shader name (see the reina_add_shader calls in CMakeLists.txt). By default that's the code
+     * embedded at build time, so no files are read. In dev mode the GLSL is compiled with glslc at runtime instead, and
+     * the results are cached on disk, keyed by a hash of the source including everything it #includes, the stage and
+     * the defines. Unchanged variants are then only read back, so edits to one shader only recompile the variants
+     * that include it.
+     */
+    class ShaderLoader {
+    public:
+        ShaderLoader() = default;
+
+        /**
+         * Dev mode.
+         * @param sourceDirectory the shaders directory with the GLSL sources
+         * @param cacheDirectory where compiled variants are kept, created if missing
+         */
+        ShaderLoader(std::string sourceDirectory, std::string cacheDirectory);
+
+        /**
+         * Throws if there is no such shader, or if compiling it fails.
+         */
+        [[nodiscard]] std::vector<uint32_t> load(std::string_view name) const;
+
+        [[nodiscard]] bool isCompilingAtRuntime() const;
+
+        /**
+         * In dev mode, the hash the compiled variant is cached under. It changes whenever the variant's source or one
+         * of its includes does, which is what ShaderReloader polls.
+         */
+        [[nodiscard]] uint64_t getSourceHash(std::string_view name) const;
+
+    private:
+        std::string sourceDirectory;  // empty if the embedded shaders are used
+        std::string cacheDirectory;
+
+        [[nodiscard]] std::vector<uint32_t> compile(const EmbeddedShader& shader, const std::string& outputPath) const;
+
+        static const EmbeddedShader& find(std::string_view name);
+        static std::vector<uint32_t> readSpirv(const std::string& filepath);
+    };
+}
+
+#endif //REINA_VK_SHADERLOADER_H
@@ -0,0 +1,75 @@
+#include "ShaderReloader.h"
+
+#include <iostream>
+#include <utility>
+
+reina::graphics::ShaderReloader::ShaderReloader(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const RtPipelineDescription& description)
+    : logicalDevice(logicalDevice), physicalDevice(physicalDevice), pipelineCache(pipelineCache), shaderLoader(shaderLoader), description(description) {
+    // started last, once everything it reads is initialized
+    worker = std::thread(&ShaderReloader::run, this);
+}
+
+std::optional<reina::graphics::RtPipeline> reina::graphics::ShaderReloader::takeRebuilt() {
+    std::lock_guard lock(mutex);
+    return std::exchange(rebuilt, std::nullopt);
+}
+
+void reina::graphics::ShaderReloader::destroy(VkDevice logicalDevice) {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+
+    stopCondition.notify_all();
+    worker.join();
+
+    if (rebuilt.has_value()) {
+        rebuilt->destroy(logicalDevice);
+        rebuilt.reset();
+    }
+}
+
+void reina::graphics::ShaderReloader::run() {
+    uint64_t builtHash = hashSources();
+
+    std::unique_lock lock(mutex);
+    while (!stopCondition.wait_for(lock, POLL_INTERVAL, [this] { return stopping; })) {
+        lock.unlock();
+
+        uint64_t hash = hashSources();
+        if (hash != builtHash) {
+            // also remembered when the build fails, so a broken shader is only reported once per change
+            builtHash = hash;
+
+            auto start = std::chrono::steady_clock::now();
+            std::optional<RtPipeline> pipeline;
+            try {
+                pipeline.emplace(logicalDevice, physicalDevice, pipelineCache, shaderLoader, description);
+            } catch (const std::exception& e) {
+                std::cerr << "Shader reload failed, keeping the current pipeline: " << e.what() << "\n";
+            }
+
+            if (pipeline.has_value()) {
+                std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+                std::cout << "Shaders reloaded in " << buildTime.count() << " ms\n";
+
+                std::lock_guard replaceLock(mutex);
+                if (rebuilt.has_value()) {
+                    rebuilt->destroy(logicalDevice);  // never handed out, so not in use
+                }
+                rebuilt = std::move(pipeline);
+            }
+        }
+
+        lock.lock();
+    }
+}
+
+uint64_t reina::graphics::ShaderReloader::hashSources() const {
+    uint64_t hash = 0;
+    for (const RtShader& shader : description.shaders) {
+        hash = hash * 31 + shaderLoader.getSourceHash(shader.name);
+    }
+
+    return hash;
+}
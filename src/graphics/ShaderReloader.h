@@ -0,0 +1,58 @@
+#ifndef REINA_VK_SHADERRELOADER_H
+#define REINA_VK_SHADERRELOADER_H
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "RtPipeline.h"
+#include "ShaderLoader.h"
+
+namespace reina::graphics {
+    /**
+     * Shader hot reload for --shader-dev. A worker thread polls the source hashes of the pipeline's shaders and, when
+     * one changes, recompiles the changed variants and builds a new pipeline and SBT next to the running one. The
+     * render loop picks it up with takeRebuilt at a frame boundary, once the GPU is done with the old one. Scene data
+     * (models, BLASes, TLAS) and the descriptor set are left alone, so a reload costs about as much as compiling the
+     * changed shaders. A failed compile is reported and the current pipeline stays in use.
+     */
+    class ShaderReloader {
+    public:
+        ShaderReloader(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const RtPipelineDescription& description);
+
+        /**
+         * The newest successfully rebuilt pipeline, if there is one the caller hasn't taken yet. The caller then owns
+         * it, and must destroy the one it replaces once no command buffer uses it anymore.
+         */
+        [[nodiscard]] std::optional<RtPipeline> takeRebuilt();
+
+        /**
+         * Stops and joins the worker, and destroys a rebuilt pipeline nobody took.
+         */
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        static constexpr std::chrono::milliseconds POLL_INTERVAL{200};
+
+        VkDevice logicalDevice;
+        VkPhysicalDevice physicalDevice;
+        VkPipelineCache pipelineCache;
+        const ShaderLoader& shaderLoader;
+        const RtPipelineDescription& description;
+
+        std::mutex mutex;
+        std::condition_variable stopCondition;
+        bool stopping = false;
+        std::optional<RtPipeline> rebuilt;
+        std::thread worker;
+
+        void run();
+        [[nodiscard]] uint64_t hashSources() const;
+    };
+}
+
+#endif //REINA_VK_SHADERRELOADER_H
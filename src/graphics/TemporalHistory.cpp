@@ -0,0 +1,91 @@
+#include "TemporalHistory.h"
+
+#include "../../polyglot/common.h"
+
+namespace {
+    constexpr size_t POSITION_IMAGE = 0;
+    constexpr size_t HISTORY_COLOR_IMAGE = 1;
+    constexpr size_t HISTORY_POSITION_IMAGE = 2;
+    constexpr size_t MOMENTS_IMAGE = 3;
+    constexpr size_t HISTORY_MOMENTS_IMAGE = 4;
+    constexpr size_t HISTORY_COMPENSATION_IMAGE = 5;
+    constexpr uint32_t FIRST_BINDING = 9;
+}
+
+reina::graphics::TemporalHistory::TemporalHistory(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height)
+    : width(width), height(height) {
+    for (size_t i = 0; i < images.size(); i++) {
+        // without compensation the binding is unused, but must still be valid
+        images[i] = i != HISTORY_COMPENSATION_IMAGE || COMPENSATED_ACCUMULATION
+                ? vktools::createRtImage(logicalDevice, physicalDevice, width, height)
+                : vktools::createRtImage(logicalDevice, physicalDevice, 1, 1);
+        imageViews[i] = vktools::createRtImageView(logicalDevice, images[i].image);
+    }
+}
+
+std::vector<reina::core::Binding> reina::graphics::TemporalHistory::getBindings() {
+    // the denoiser's compute passes read the positions and moments
+    std::vector<reina::core::Binding> bindings;
+    for (uint32_t i = 0; i < 6; i++) {
+        bindings.push_back(reina::core::Binding{FIRST_BINDING + i, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT});
+    }
+
+    return bindings;
+}
+
+void reina::graphics::TemporalHistory::writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const {
+    for (size_t i = 0; i < imageViews.size(); i++) {
+        VkDescriptorImageInfo imageInfo{.imageView = imageViews[i], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+        sceneDescriptorSet.writeBinding(logicalDevice, FIRST_BINDING + static_cast<uint32_t>(i), &imageInfo, nullptr, nullptr, nullptr);
+    }
+}
+
+void reina::graphics::TemporalHistory::recordInitialization(VkCommandBuffer cmdBuffer) const {
+    std::array<VkImageMemoryBarrier, 6> barriers{};
+    for (size_t i = 0; i < images.size(); i++) {
+        barriers[i] = vktools::imageBarrier(images[i].image, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    // a depth of 0 marks a pixel without a surface
+    VkClearColorValue zero{};
+    VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    for (const vktools::ImageObjects& image : images) {
+        vkCmdClearColorImage(cmdBuffer, image.image, VK_IMAGE_LAYOUT_GENERAL, &zero, 1, &range);
+    }
+
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+                           VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void reina::graphics::TemporalHistory::recordCopy(VkCommandBuffer cmdBuffer, VkImage rtImage, VkImage compensationImage) const {
+    // the previous dispatch wrote the images, the tone mapper, the denoiser and the previous dispatch read them
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+
+    vktools::copyImage(cmdBuffer, rtImage, images[HISTORY_COLOR_IMAGE].image, width, height);
+    vktools::copyImage(cmdBuffer, images[POSITION_IMAGE].image, images[HISTORY_POSITION_IMAGE].image, width, height);
+    vktools::copyImage(cmdBuffer, images[MOMENTS_IMAGE].image, images[HISTORY_MOMENTS_IMAGE].image, width, height);
+    if (COMPENSATED_ACCUMULATION) {
+        vktools::copyImage(cmdBuffer, compensationImage, images[HISTORY_COMPENSATION_IMAGE].image, width, height);
+    }
+
+    vktools::memoryBarrier(cmdBuffer,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void reina::graphics::TemporalHistory::destroy(VkDevice logicalDevice) {
+    for (size_t i = 0; i < images.size(); i++) {
+        vkDestroyImageView(logicalDevice, imageViews[i], nullptr);
+        vkDestroyImage(logicalDevice, images[i].image, nullptr);
+        vkFreeMemory(logicalDevice, images[i].imageMemory, nullptr);
+    }
+}
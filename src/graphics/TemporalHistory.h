@@ -0,0 +1,60 @@
+#ifndef REINA_VK_TEMPORALHISTORY_H
+#define REINA_VK_TEMPORALHISTORY_H
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <vector>
+
+#include "../core/DescriptorSet.h"
+#include "../tools/vktools.h"
+
+namespace reina::graphics {
+    /**
+     * Keeps the samples of a still image when the camera moves, instead of starting over. The raygen shader variant
+     * raytrace.reproject.rgen writes the world position and view depth of every pixel's first hit to a position image,
+     * next to the accumulation image with each pixel's sum and sample count (see Accumulator). When the camera moves,
+     * both are copied to the history, and the first pass after the move starts each pixel from the history pixel its new
+     * hit projects to with the previous view, unless that pixel saw a different surface (disocclusion) or was off screen.
+     *
+     * The same shader writes the luminance moments of each pixel's samples, which are reprojected with the color. The
+     * Denoiser filters with the positions and moments, and takes the albedo and normal from AovImages.
+     *
+     * The history keeps the Kahan compensation of the sums too, so a reprojected pixel starts from the same mean the
+     * resolve pass showed.
+     *
+     * Adds bindings 9 to 14 to the ray tracing descriptor set, see shaders/reprojection.h.glsl.
+     */
+    class TemporalHistory {
+    public:
+        TemporalHistory(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height);
+
+        [[nodiscard]] static std::vector<reina::core::Binding> getBindings();
+        void writeDescriptors(VkDevice logicalDevice, reina::core::DescriptorSet& sceneDescriptorSet) const;
+
+        /**
+         * Moves the images into the general layout and clears the positions, so nothing reprojects onto an image that
+         * was never traced. Must be recorded before the first dispatch.
+         */
+        void recordInitialization(VkCommandBuffer cmdBuffer) const;
+
+        /**
+         * Copies the ray traced image, its compensation (see Accumulator), the positions and the moments into the history.
+         * Synchronizes with the previous dispatch, the tone mapper and the dispatch that follows. The ray traced image
+         * must be in the general layout.
+         */
+        void recordCopy(VkCommandBuffer cmdBuffer, VkImage rtImage, VkImage compensationImage) const;
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        uint32_t width;
+        uint32_t height;
+
+        // in binding order
+        std::array<vktools::ImageObjects, 6> images;
+        std::array<VkImageView, 6> imageViews{};
+    };
+}
+
+#endif //REINA_VK_TEMPORALHISTORY_H
@@ -0,0 +1,151 @@
+#include "ToneMapper.h"
+
+#include <array>
+#include <stdexcept>
+
+#include "Shader.h"
+#include "../../polyglot/common.h"
+
+namespace {
+    constexpr VkFormat LDR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+reina::graphics::ToneMapper::ToneMapper(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, VkImageView displayView, uint32_t width, uint32_t height)
+    : width(width), height(height),
+      ldrImage(vktools::createRtImage(logicalDevice, physicalDevice, width, height, LDR_FORMAT)),
+      ldrView(vktools::createRtImageView(logicalDevice, ldrImage.image, LDR_FORMAT)),
+      histogram(logicalDevice, physicalDevice, sizeof(uint32_t) * TONEMAP_HISTOGRAM_BINS,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+      exposure(logicalDevice, physicalDevice, sizeof(float),
+               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+      descriptorSet(logicalDevice, {
+              reina::core::Binding{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT}
+      }) {
+    VkDescriptorImageInfo displayInfo{.imageView = displayView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    descriptorSet.writeBinding(logicalDevice, 0, &displayInfo, nullptr, nullptr, nullptr);
+
+    VkDescriptorImageInfo ldrInfo{.imageView = ldrView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    descriptorSet.writeBinding(logicalDevice, 1, &ldrInfo, nullptr, nullptr, nullptr);
+
+    VkDescriptorBufferInfo histogramInfo{.buffer = histogram.getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    descriptorSet.writeBinding(logicalDevice, 2, nullptr, &histogramInfo, nullptr, nullptr);
+
+    VkDescriptorBufferInfo exposureInfo{.buffer = exposure.getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    descriptorSet.writeBinding(logicalDevice, 3, nullptr, &exposureInfo, nullptr, nullptr);
+
+    VkDescriptorSetLayout setLayout = descriptorSet.getLayout();
+    VkPushConstantRange pushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = sizeof(ToneMapPushConstantsStruct)
+    };
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 1,
+            .pSetLayouts = &setLayout,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange
+    };
+
+    if (vkCreatePipelineLayout(logicalDevice, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Cannot create tonemapping pipeline layout");
+    }
+
+    Shader applyShader{logicalDevice, shaderLoader.load("tonemap.apply.comp"), VK_SHADER_STAGE_COMPUTE_BIT};
+    applyPipeline = vktools::createComputePipeline(logicalDevice, pipelineCache, pipelineLayout, applyShader);
+    applyShader.destroy(logicalDevice);
+
+    Shader exposureShader{logicalDevice, shaderLoader.load("tonemap.exposure.comp"), VK_SHADER_STAGE_COMPUTE_BIT};
+    exposurePipeline = vktools::createComputePipeline(logicalDevice, pipelineCache, pipelineLayout, exposureShader);
+    exposureShader.destroy(logicalDevice);
+}
+
+void reina::graphics::ToneMapper::recordInitialization(VkCommandBuffer cmdBuffer) {
+    // the layout the blit leaves it in, which is where record starts
+    VkImageMemoryBarrier barrier = vktools::imageBarrier(ldrImage.image, 0, 0, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    // an adapted luminance of 0 makes the first exposure pass take its target as is
+    vkCmdFillBuffer(cmdBuffer, histogram.getHandle(), 0, VK_WHOLE_SIZE, 0);
+    vkCmdFillBuffer(cmdBuffer, exposure.getHandle(), 0, VK_WHOLE_SIZE, 0);
+    vktools::memoryBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void reina::graphics::ToneMapper::record(VkCommandBuffer cmdBuffer, VkImage swapchainImage, VkExtent2D swapchainExtent, float deltaTime) {
+    // the previous frame's exposure pass wrote the exposure and cleared the histogram, and its blit read the tonemapped
+    // image, which this frame's pass overwrites
+    VkMemoryBarrier bufferBarrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    };
+    VkImageMemoryBarrier ldrBarrier = vktools::imageBarrier(ldrImage.image, 0, VK_ACCESS_SHADER_WRITE_BIT,
+                                                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &bufferBarrier, 0, nullptr, 1, &ldrBarrier);
+
+    descriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0);
+
+    ToneMapPushConstantsStruct pushConstants{deltaTime};
+    vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, applyPipeline);
+    vkCmdDispatch(cmdBuffer, (width + TONEMAP_WORKGROUP_SIZE - 1) / TONEMAP_WORKGROUP_SIZE, (height + TONEMAP_WORKGROUP_SIZE - 1) / TONEMAP_WORKGROUP_SIZE, 1);
+
+    // the histogram is complete, and the exposure was read by every pixel
+    vktools::memoryBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, exposurePipeline);
+    vkCmdDispatch(cmdBuffer, 1, 1, 1);
+
+    std::array<VkImageMemoryBarrier, 2> blitBarriers{
+            vktools::imageBarrier(ldrImage.image, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                                  VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL),
+            vktools::imageBarrier(swapchainImage, 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+    };
+    // the acquire semaphore is waited on at the transfer stage, so the swapchain image's transition has to come after
+    // that stage, or it could run before the presentation engine released the image
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(blitBarriers.size()), blitBarriers.data());
+
+    // swaps the channels for a BGRA swapchain (see chooseSwapSurfaceFormat), and scales if the window size differs
+    // from the render size
+    VkImageBlit blit{
+            .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+            .srcOffsets = {{0, 0, 0}, {static_cast<int32_t>(width), static_cast<int32_t>(height), 1}},
+            .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+            .dstOffsets = {{0, 0, 0}, {static_cast<int32_t>(swapchainExtent.width), static_cast<int32_t>(swapchainExtent.height), 1}}
+    };
+    vkCmdBlitImage(cmdBuffer, ldrImage.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1, &blit, VK_FILTER_NEAREST);
+
+    VkImageMemoryBarrier presentBarrier = vktools::imageBarrier(swapchainImage, VK_ACCESS_TRANSFER_WRITE_BIT, 0,
+                                                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &presentBarrier);
+}
+
+VkBuffer reina::graphics::ToneMapper::getExposureBuffer() const {
+    return exposure.getHandle();
+}
+
+void reina::graphics::ToneMapper::destroy(VkDevice logicalDevice) {
+    vkDestroyPipeline(logicalDevice, applyPipeline, nullptr);
+    vkDestroyPipeline(logicalDevice, exposurePipeline, nullptr);
+    vkDestroyPipelineLayout(logicalDevice, pipelineLayout, nullptr);
+    descriptorSet.destroy(logicalDevice);
+
+    histogram.destroy(logicalDevice);
+    exposure.destroy(logicalDevice);
+    vkDestroyImageView(logicalDevice, ldrView, nullptr);
+    vkDestroyImage(logicalDevice, ldrImage.image, nullptr);
+    vkFreeMemory(logicalDevice, ldrImage.imageMemory, nullptr);
+}
@@ -0,0 +1,63 @@
+#ifndef REINA_VK_TONEMAPPER_H
+#define REINA_VK_TONEMAPPER_H
+
+#include <vulkan/vulkan.h>
+
+#include "../core/Buffer.h"
+#include "../core/DescriptorSet.h"
+#include "../tools/vktools.h"
+#include "ShaderLoader.h"
+
+namespace reina::graphics {
+    /**
+     * Takes the display image to the swapchain with two compute passes instead of a render pass:
+     *  - tonemap.apply exposes and tonemaps every pixel into an rgba8 image and adds up a histogram of their log2
+     *    luminance, in shared memory first so there is only one global atomic per bin and workgroup
+     *  - tonemap.exposure, a single workgroup, reduces the histogram to the geometric mean luminance and moves the
+     *    exposure towards it, at a rate independent of the frame rate
+     * The rgba8 image is then blitted to the swapchain image, which doesn't need storage usage or a format a compute
+     * shader can write. Each frame is exposed for the previous frame's histogram, and the exposure only leaves the GPU
+     * for captures (ImageExporter), so PNGs are exposed like the window. See the TONEMAP_ constants in polyglot/common.h.
+     */
+    class ToneMapper {
+    public:
+        ToneMapper(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, VkImageView displayView, uint32_t width, uint32_t height);
+
+        /**
+         * Initializes the tonemapped image's layout and clears the histogram and the exposure. Must be recorded before
+         * the first record.
+         */
+        void recordInitialization(VkCommandBuffer cmdBuffer);
+
+        /**
+         * Records both passes and the blit, after the display image was written. Leaves the swapchain image ready to
+         * present, its previous contents are discarded.
+         *
+         * @param deltaTime seconds since the previous frame, for the exposure adaptation
+         */
+        void record(VkCommandBuffer cmdBuffer, VkImage swapchainImage, VkExtent2D swapchainExtent, float deltaTime);
+
+        /**
+         * A single float, the adapted luminance of tonemap.h.glsl. Written by the exposure pass, in compute shaders.
+         */
+        [[nodiscard]] VkBuffer getExposureBuffer() const;
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        uint32_t width;
+        uint32_t height;
+
+        vktools::ImageObjects ldrImage;
+        VkImageView ldrView;
+        reina::core::Buffer histogram;
+        reina::core::Buffer exposure;
+        reina::core::DescriptorSet descriptorSet;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline applyPipeline = VK_NULL_HANDLE;
+        VkPipeline exposurePipeline = VK_NULL_HANDLE;
+    };
+}
+
+#endif //REINA_VK_TONEMAPPER_H
@@ -0,0 +1,94 @@
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // same conversions as packSnorm2x16 and unpackSnorm2x16 in GLSL
+    uint32_t packSnorm16(float value) {
+        auto quantized = static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+        return static_cast<uint16_t>(quantized);
+    }
+
+    float unpackSnorm16(uint32_t bits) {
+        auto quantized = static_cast<int16_t>(static_cast<uint16_t>(bits & 0xFFFF));
+        return std::clamp(static_cast<float>(quantized) / 32767.0f, -1.0f, 1.0f);
+    }
+
+    glm::vec2 signNotZero(glm::vec2 v) {
+        return {v.x >= 0 ? 1.0f : -1.0f, v.y >= 0 ? 1.0f : -1.0f};
+    }
+}
+
+reina::graphics::QuantizationBounds reina::graphics::computeQuantizationBounds(const std::vector<float>& vertices, size_t firstFloat, size_t floatCount) {
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(std::numeric_limits<float>::lowest());
+
+    for (size_t i = firstFloat; i < firstFloat + floatCount; i += 4) {
+        glm::vec3 position(vertices[i], vertices[i + 1], vertices[i + 2]);
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+    }
+
+    if (floatCount == 0) {
+        return {glm::vec3(0), glm::vec3(1)};
+    }
+
+    glm::vec3 halfExtent = (max - min) * 0.5f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (halfExtent[axis] <= 0) {
+            halfExtent[axis] = 1;
+        }
+    }
+
+    return {(min + max) * 0.5f, halfExtent};
+}
+
+glm::uvec2 reina::graphics::quantizePosition(glm::vec3 position, const QuantizationBounds& bounds) {
+    glm::vec3 normalized = (position - bounds.center) / bounds.halfExtent;
+
+    return {
+            packSnorm16(normalized.x) | (packSnorm16(normalized.y) << 16),
+            packSnorm16(normalized.z)
+    };
+}
+
+glm::vec3 reina::graphics::dequantizePosition(glm::uvec2 packed, const QuantizationBounds& bounds) {
+    glm::vec3 normalized(unpackSnorm16(packed.x), unpackSnorm16(packed.x >> 16), unpackSnorm16(packed.y));
+    return bounds.center + normalized * bounds.halfExtent;
+}
+
+glm::mat4 reina::graphics::getDequantizeTransform(const QuantizationBounds& bounds) {
+    glm::mat4 transform(1.0f);
+    transform[0][0] = bounds.halfExtent.x;
+    transform[1][1] = bounds.halfExtent.y;
+    transform[2][2] = bounds.halfExtent.z;
+    transform[3] = glm::vec4(bounds.center, 1.0f);
+
+    return transform;
+}
+
+uint32_t reina::graphics::encodeOctahedral(glm::vec3 normal) {
+    normal /= std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+
+    glm::vec2 encoded(normal.x, normal.y);
+    if (normal.z < 0) {
+        encoded = (1.0f - glm::abs(glm::vec2(encoded.y, encoded.x))) * signNotZero(encoded);
+    }
+
+    return packSnorm16(encoded.x) | (packSnorm16(encoded.y) << 16);
+}
+
+glm::vec3 reina::graphics::decodeOctahedral(uint32_t encoded) {
+    glm::vec2 e(unpackSnorm16(encoded), unpackSnorm16(encoded >> 16));
+    glm::vec3 normal(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+
+    if (normal.z < 0) {
+        glm::vec2 folded = (1.0f - glm::abs(glm::vec2(normal.y, normal.x))) * signNotZero(glm::vec2(normal.x, normal.y));
+        normal.x = folded.x;
+        normal.y = folded.y;
+    }
+
+    return glm::normalize(normal);
+}
@@ -0,0 +1,44 @@
+#ifndef REINA_VK_VERTEXCOMPRESSION_H
+#define REINA_VK_VERTEXCOMPRESSION_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace reina::graphics {
+    /**
+     * Axis-aligned bounds of a mesh. Quantized positions are relative to these: (position - center) / halfExtent is
+     * stored as 16-bit SNORM, which is R16G16B16A16_SNORM and can be fed to the BLAS builder directly.
+     */
+    struct QuantizationBounds {
+        glm::vec3 center;
+        glm::vec3 halfExtent;  // never 0, so flat meshes still have an invertible dequantize transform
+    };
+
+    /**
+     * @param vertices 4 floats per vertex, w ignored
+     */
+    [[nodiscard]] QuantizationBounds computeQuantizationBounds(const std::vector<float>& vertices, size_t firstFloat, size_t floatCount);
+
+    /**
+     * Packs a position into two uints: x | y << 16 and z | 0 << 16, each component a 16-bit SNORM.
+     */
+    [[nodiscard]] glm::uvec2 quantizePosition(glm::vec3 position, const QuantizationBounds& bounds);
+    [[nodiscard]] glm::vec3 dequantizePosition(glm::uvec2 packed, const QuantizationBounds& bounds);
+
+    /**
+     * Maps the [-1, 1] quantized space back to object space. Folded into the instance transform, so neither the BLAS nor
+     * the hit shader has to know about the bounds.
+     */
+    [[nodiscard]] glm::mat4 getDequantizeTransform(const QuantizationBounds& bounds);
+
+    /**
+     * Octahedral encoding of a unit vector into two 16-bit SNORMs packed in a uint, see "A Survey of Efficient
+     * Representations for Independent Unit Vectors" (Cigolle et al., 2014). Decoded by decodeOctahedral in
+     * vertexCompression.h.glsl.
+     */
+    [[nodiscard]] uint32_t encodeOctahedral(glm::vec3 normal);
+    [[nodiscard]] glm::vec3 decodeOctahedral(uint32_t encoded);
+}
+
+#endif //REINA_VK_VERTEXCOMPRESSION_H
@@ -0,0 +1,173 @@
+#include "WavefrontIntegrator.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "Shader.h"
+#include "../tools/vktools.h"
+
+namespace {
+    constexpr uint32_t RAY_QUEUES = 2;  // the material queues follow
+
+    constexpr VkBufferUsageFlags STORAGE = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    constexpr VkMemoryPropertyFlags DEVICE_LOCAL = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    // every pass reads what the previous one wrote, be it through shaders, the queue counter resets or the indirect
+    // dispatch arguments
+    void barrier(VkCommandBuffer cmdBuffer) {
+        VkMemoryBarrier memoryBarrier{
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+        };
+
+        vkCmdPipelineBarrier(
+                cmdBuffer,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                0,
+                1, &memoryBarrier,
+                0, nullptr,
+                0, nullptr
+        );
+    }
+}
+
+reina::graphics::WavefrontIntegrator::WavefrontIntegrator(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, uint32_t width, uint32_t height)
+    : pathCount(width * height),
+      paths(logicalDevice, physicalDevice, sizeof(WavefrontPath) * pathCount, STORAGE, 0, DEVICE_LOCAL),
+      hits(logicalDevice, physicalDevice, sizeof(WavefrontHit) * pathCount, STORAGE, 0, DEVICE_LOCAL),
+      queues(logicalDevice, physicalDevice, sizeof(uint32_t) * pathCount * WAVEFRONT_QUEUE_COUNT, STORAGE, 0, DEVICE_LOCAL),
+      queueCounters(logicalDevice, physicalDevice, sizeof(WavefrontQueueCounter) * WAVEFRONT_QUEUE_COUNT,
+                    STORAGE | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0, DEVICE_LOCAL),
+      sampleSums(logicalDevice, physicalDevice, sizeof(float) * 4 * pathCount, STORAGE, 0, DEVICE_LOCAL),
+      descriptorSet(logicalDevice, {
+              reina::core::Binding{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT},
+              reina::core::Binding{4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT}
+      }) {
+    const reina::core::Buffer* buffers[] = {&paths, &hits, &queues, &queueCounters, &sampleSums};
+    for (int binding = 0; binding < static_cast<int>(std::size(buffers)); binding++) {
+        VkDescriptorBufferInfo bufferInfo{.buffer = buffers[binding]->getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+        descriptorSet.writeBinding(logicalDevice, binding, nullptr, &bufferInfo, nullptr, nullptr);
+    }
+
+    VkDescriptorSetLayout setLayouts[] = {sceneDescriptorSet.getLayout(), descriptorSet.getLayout()};
+    VkPushConstantRange pushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = sizeof(WavefrontPushConstantsStruct)
+    };
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 2,
+            .pSetLayouts = setLayouts,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange
+    };
+
+    if (vkCreatePipelineLayout(logicalDevice, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Cannot create wavefront pipeline layout");
+    }
+
+    auto createPipeline = [&](const std::string& shaderName) {
+        Shader shader{logicalDevice, shaderLoader.load(shaderName), VK_SHADER_STAGE_COMPUTE_BIT};
+        VkPipeline pipeline = vktools::createComputePipeline(logicalDevice, pipelineCache, pipelineLayout, shader);
+        shader.destroy(logicalDevice);
+
+        return pipeline;
+    };
+
+    generatePipeline = createPipeline("wavefront.generate.comp");
+    intersectPipeline = createPipeline("wavefront.intersect.comp");
+    shadePipelines = {
+            createPipeline("wavefront.shade.lambertian.comp"),
+            createPipeline("wavefront.shade.metal.comp"),
+            createPipeline("wavefront.shade.dielectric.comp")
+    };
+    accumulatePipeline = createPipeline("wavefront.accumulate.comp");
+}
+
+void reina::graphics::WavefrontIntegrator::record(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet, const PushConstantsStruct& frame) {
+    sceneDescriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0);
+    descriptorSet.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 1);
+
+    for (uint32_t sampleIndex = 0; sampleIndex < frame.samplesPerPixel; sampleIndex++) {
+        barrier(cmdBuffer);
+        resetQueues(cmdBuffer, 0, WAVEFRONT_QUEUE_COUNT);
+        barrier(cmdBuffer);
+
+        pushConstants(cmdBuffer, frame, sampleIndex, 0);
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, generatePipeline);
+        dispatchPaths(cmdBuffer);
+
+        for (uint32_t bounce = 0; bounce < BOUNCES_PER_SAMPLE; bounce++) {
+            uint32_t rayQueue = bounce % RAY_QUEUES;
+
+            // the queues this bounce appends to. the first bounce's were just reset with the others
+            if (bounce > 0) {
+                barrier(cmdBuffer);
+                resetQueues(cmdBuffer, 1 - rayQueue, 1);
+                resetQueues(cmdBuffer, RAY_QUEUES, MATERIAL_COUNT);
+            }
+
+            barrier(cmdBuffer);
+            pushConstants(cmdBuffer, frame, sampleIndex, rayQueue);
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, intersectPipeline);
+            dispatchQueue(cmdBuffer, rayQueue);
+
+            // the material queues are disjoint, so the shading kernels can overlap
+            barrier(cmdBuffer);
+            for (uint32_t material = 0; material < MATERIAL_COUNT; material++) {
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, shadePipelines[material]);
+                dispatchQueue(cmdBuffer, RAY_QUEUES + material);
+            }
+        }
+
+        barrier(cmdBuffer);
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, accumulatePipeline);
+        dispatchPaths(cmdBuffer);
+    }
+}
+
+void reina::graphics::WavefrontIntegrator::resetQueues(VkCommandBuffer cmdBuffer, uint32_t firstQueue, uint32_t queueCount) {
+    // empty, with the indirect dispatch arguments of an empty queue
+    std::array<WavefrontQueueCounter, WAVEFRONT_QUEUE_COUNT> emptyCounters;
+    emptyCounters.fill(WavefrontQueueCounter{0, 1, 1, 0});
+
+    vkCmdUpdateBuffer(cmdBuffer, queueCounters.getHandle(), firstQueue * sizeof(WavefrontQueueCounter),
+                      queueCount * sizeof(WavefrontQueueCounter), emptyCounters.data());
+}
+
+void reina::graphics::WavefrontIntegrator::dispatchQueue(VkCommandBuffer cmdBuffer, uint32_t queue) {
+    vkCmdDispatchIndirect(cmdBuffer, queueCounters.getHandle(), queue * sizeof(WavefrontQueueCounter));
+}
+
+void reina::graphics::WavefrontIntegrator::dispatchPaths(VkCommandBuffer cmdBuffer) const {
+    vkCmdDispatch(cmdBuffer, (pathCount + WAVEFRONT_WORKGROUP_SIZE - 1) / WAVEFRONT_WORKGROUP_SIZE, 1, 1);
+}
+
+void reina::graphics::WavefrontIntegrator::pushConstants(VkCommandBuffer cmdBuffer, const PushConstantsStruct& frame, uint32_t sampleIndex, uint32_t rayQueue) {
+    WavefrontPushConstantsStruct data{frame, sampleIndex, rayQueue};
+    vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(data), &data);
+}
+
+void reina::graphics::WavefrontIntegrator::destroy(VkDevice logicalDevice) {
+    vkDestroyPipeline(logicalDevice, generatePipeline, nullptr);
+    vkDestroyPipeline(logicalDevice, intersectPipeline, nullptr);
+    for (VkPipeline pipeline : shadePipelines) {
+        vkDestroyPipeline(logicalDevice, pipeline, nullptr);
+    }
+    vkDestroyPipeline(logicalDevice, accumulatePipeline, nullptr);
+    vkDestroyPipelineLayout(logicalDevice, pipelineLayout, nullptr);
+
+    descriptorSet.destroy(logicalDevice);
+    paths.destroy(logicalDevice);
+    hits.destroy(logicalDevice);
+    queues.destroy(logicalDevice);
+    queueCounters.destroy(logicalDevice);
+    sampleSums.destroy(logicalDevice);
+}
@@ -0,0 +1,62 @@
+#ifndef REINA_VK_WAVEFRONTINTEGRATOR_H
+#define REINA_VK_WAVEFRONTINTEGRATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+
+#include "../core/Buffer.h"
+#include "../core/DescriptorSet.h"
+#include "../../polyglot/common.h"
+#include "ShaderLoader.h"
+
+namespace reina::graphics {
+    /**
+     * An alternative to the ray tracing pipeline's megakernel, selected with --integrator wavefront. Each bounce is split
+     * into compute passes that trace with ray queries:
+     *  - intersect: traces the live paths of a ray queue and appends every hit to the queue of its material
+     *  - shade: one kernel per material queue, so the threads of a group don't diverge on material code. Each
+     *    continuing path is appended to the other ray queue, which compacts the live paths
+     * A generation pass fills the first ray queue with one path per pixel, and after the last bounce an accumulation
+     * pass adds the sample to the image. The queue lengths are only known on the GPU, so the passes that consume a
+     * queue are indirect dispatches sized by the queue's counter. Renders the same image as the megakernel, with the
+     * same RNG sequence per pixel.
+     *
+     * Uses the ray tracing descriptor set as set 0, which needs compute in the stage flags of its bindings.
+     */
+    class WavefrontIntegrator {
+    public:
+        WavefrontIntegrator(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache, const ShaderLoader& shaderLoader, const reina::core::DescriptorSet& sceneDescriptorSet, uint32_t width, uint32_t height);
+
+        /**
+         * Records one batch of frame.samplesPerPixel samples of the whole image, the same amount of work as one trace
+         * rays call of the megakernel. frame.firstRow is ignored. The storage image must be in the general layout.
+         */
+        void record(VkCommandBuffer cmdBuffer, reina::core::DescriptorSet& sceneDescriptorSet, const PushConstantsStruct& frame);
+
+        void destroy(VkDevice logicalDevice);
+
+    private:
+        uint32_t pathCount;
+
+        reina::core::Buffer paths;
+        reina::core::Buffer hits;
+        reina::core::Buffer queues;
+        reina::core::Buffer queueCounters;
+        reina::core::Buffer sampleSums;
+        reina::core::DescriptorSet descriptorSet;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline generatePipeline = VK_NULL_HANDLE;
+        VkPipeline intersectPipeline = VK_NULL_HANDLE;
+        std::array<VkPipeline, MATERIAL_COUNT> shadePipelines{};
+        VkPipeline accumulatePipeline = VK_NULL_HANDLE;
+
+        void resetQueues(VkCommandBuffer cmdBuffer, uint32_t firstQueue, uint32_t queueCount);
+        void dispatchQueue(VkCommandBuffer cmdBuffer, uint32_t queue);
+        void dispatchPaths(VkCommandBuffer cmdBuffer) const;
+        void pushConstants(VkCommandBuffer cmdBuffer, const PushConstantsStruct& frame, uint32_t sampleIndex, uint32_t rayQueue);
+    };
+}
+
+#endif //REINA_VK_WAVEFRONTINTEGRATOR_H
@@ -6,7 +6,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <vulkan/vulkan.h>
 
 #include "tools/vktools.h"
@@ -14,11 +17,24 @@
 #include "window/Window.h"
 #include "core/DescriptorSet.h"
 #include "core/PushConstants.h"
-#include "graphics/Models.h"
-#include "graphics/ObjectProperties.h"
-#include "graphics/Blas.h"
-#include "graphics/Instance.h"
+#include "core/PipelineCache.h"
+#include "core/GpuTimer.h"
+#include "graphics/Scene.h"
+#include "graphics/ShaderLoader.h"
+#include "graphics/RtPipeline.h"
+#include "graphics/ShaderReloader.h"
+#include "graphics/WavefrontIntegrator.h"
+#include "graphics/SampleScheduler.h"
+#include "graphics/AdaptiveSampler.h"
+#include "graphics/TemporalHistory.h"
+#include "graphics/Denoiser.h"
+#include "graphics/AovImages.h"
+#include "graphics/Accumulator.h"
+#include "graphics/ToneMapper.h"
+#include "graphics/ImageExporter.h"
 #include "tools/Clock.h"
+#include "tools/Options.h"
+#include "tools/Bench.h"
 #include "graphics/Camera.h"
 
 VkDeviceAddress getBufferDeviceAddress(VkDevice device, VkBuffer buffer)
@@ -67,111 +83,146 @@ void transitionImage(
 }
 
 
-void run() {
+void run(const reina::tools::Options& options) {
+    // the benchmark renders headless: no display, surface or swapchain, so it also runs on CI machines
+    const reina::tools::BenchOptions& benchOptions = options.bench;
+    const bool headless = benchOptions.enabled;
+
     // init
-    reina::window::Window renderWindow{800, 800};
+    reina::window::Window renderWindow{
+            headless ? static_cast<int>(benchOptions.width) : 800,
+            headless ? static_cast<int>(benchOptions.height) : 800,
+            headless
+    };
     renderWindow.setInputMode(GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     VkInstance instance = vktools::createInstance();
     std::optional<VkDebugUtilsMessengerEXT> debugMessenger = vktools::createDebugMessenger(instance);
-    VkSurfaceKHR surface = vktools::createSurface(instance, renderWindow.getGlfwWindow());
+    VkSurfaceKHR surface = headless ? VK_NULL_HANDLE : vktools::createSurface(instance, renderWindow.getGlfwWindow());
     VkPhysicalDevice physicalDevice = vktools::pickPhysicalDevice(instance, surface);
     VkDevice logicalDevice = vktools::createLogicalDevice(surface, physicalDevice);
 
     vktools::QueueFamilyIndices indices = vktools::findQueueFamilies(surface, physicalDevice);
     VkQueue graphicsQueue;
     VkQueue presentQueue;
+    VkQueue transferQueue;
     vkGetDeviceQueue(logicalDevice, indices.graphicsFamily.value(), 0, &graphicsQueue);
     vkGetDeviceQueue(logicalDevice, indices.presentFamily.value(), 0, &presentQueue);
+    vkGetDeviceQueue(logicalDevice, indices.transferFamily.value(), 0, &transferQueue);
 
-    vktools::SwapchainObjects swapchainObjects = vktools::createSwapchain(surface, physicalDevice, logicalDevice, renderWindow.getWidth(), renderWindow.getHeight());
-    std::vector<VkImageView> swapchainImageViews = vktools::createSwapchainImageViews(logicalDevice, swapchainObjects.swapchainImageFormat, swapchainObjects.swapchainImages);
+    // without a swapchain only the extent is used, to size the ray tracing image
+    vktools::SwapchainObjects swapchainObjects = headless
+            ? vktools::SwapchainObjects{VK_NULL_HANDLE, {}, VK_FORMAT_R8G8B8A8_UNORM, {benchOptions.width, benchOptions.height}}
+            : vktools::createSwapchain(surface, physicalDevice, logicalDevice, renderWindow.getWidth(), renderWindow.getHeight());
 
     vktools::ImageObjects rtImageObjects = vktools::createRtImage(logicalDevice, physicalDevice, swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height);
     VkImageView rtImageView = vktools::createRtImageView(logicalDevice, rtImageObjects.image);
 
-    reina::core::DescriptorSet rtDescriptorSet{
-        logicalDevice,
-            {
-                    reina::core::Binding{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR},
-                    reina::core::Binding{1, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR},
-                    reina::core::Binding{2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
-                    reina::core::Binding{3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
-                    reina::core::Binding{4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR}
-        }
+    std::vector<reina::core::Binding> rtBindings{
+            reina::core::Binding{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT},
+            reina::core::Binding{1, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT},
+            reina::core::Binding{2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT},
+            reina::core::Binding{3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT},
+            reina::core::Binding{4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_INTERSECTION_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT},
+            reina::core::Binding{5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT},
+            reina::core::Binding{6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_INTERSECTION_BIT_KHR | VK_SHADER_STAGE_COMPUTE_BIT}
     };
 
-    glm::mat4 proj = glm::perspective(glm::radians(22.5f), static_cast<float>(swapchainObjects.swapchainExtent.width) / static_cast<float>(swapchainObjects.swapchainExtent.height), 0.1f, 100.0f);
-
-    float aspectRatio = static_cast<float>(swapchainObjects.swapchainExtent.width) / static_cast<float>(swapchainObjects.swapchainExtent.height);
-    reina::graphics::Camera camera{renderWindow, glm::radians(22.5f), aspectRatio, glm::vec3(0, 1, 0.9f), glm::vec3(0, 0, -1)};
-    reina::core::PushConstants pushConstants{PushConstantsStruct{camera.getInverseView(), camera.getInverseProjection(), 0}, VK_SHADER_STAGE_RAYGEN_BIT_KHR};
-
-    vktools::SbtSpacing sbtSpacing = vktools::calculateSbtSpacing(physicalDevice);
-    std::vector<reina::graphics::Shader> shaders = {
-            reina::graphics::Shader(logicalDevice, "../shaders/raytrace.rgen.spv", VK_SHADER_STAGE_RAYGEN_BIT_KHR),
-            reina::graphics::Shader(logicalDevice, "../shaders/raytrace.rmiss.spv", VK_SHADER_STAGE_MISS_BIT_KHR),
-            reina::graphics::Shader(logicalDevice, "../shaders/lambertian.rchit.spv", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR),
-            reina::graphics::Shader(logicalDevice, "../shaders/metal.rchit.spv", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR),
-            reina::graphics::Shader(logicalDevice, "../shaders/dielectric.rchit.spv", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
-    };
+    // every raygen variant has the AOV bindings, disabled AOVs are only left out by specialization. the denoiser filters
+    // with the albedo and normal, whether or not they are written out
+    const bool denoising = options.denoiseIterations > 0 && !headless;
+    const uint32_t enabledAovs = reina::graphics::AovImages::parseNames(options.aovs) | (denoising ? AOV_ALBEDO | AOV_NORMAL : 0u);
+    std::vector<reina::core::Binding> aovBindings = reina::graphics::AovImages::getBindings();
+    rtBindings.insert(rtBindings.end(), aovBindings.begin(), aovBindings.end());
 
-    vktools::PipelineInfo rtPipelineInfo = vktools::createRtPipeline(logicalDevice, rtDescriptorSet, shaders, pushConstants);
-    reina::core::Buffer sbtBuffer = vktools::createSbt(logicalDevice, physicalDevice, rtPipelineInfo.pipeline, sbtSpacing, shaders.size());
+    std::vector<reina::core::Binding> accumulatorBindings = reina::graphics::Accumulator::getBindings();
+    rtBindings.insert(rtBindings.end(), accumulatorBindings.begin(), accumulatorBindings.end());
 
-    for (reina::graphics::Shader& shader : shaders) {
-        shader.destroy(logicalDevice);
+    const bool adaptive = options.adaptiveThreshold > 0;
+    if (adaptive) {
+        std::vector<reina::core::Binding> adaptiveBindings = reina::graphics::AdaptiveSampler::getBindings();
+        rtBindings.insert(rtBindings.end(), adaptiveBindings.begin(), adaptiveBindings.end());
     }
 
-    reina::core::DescriptorSet rasterizationDescriptorSet{
-        logicalDevice,
-        {
-                reina::core::Binding{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT}
-        }
-    };
+    // adaptive sampling keeps its own per pixel statistics, and the benchmark never moves the camera. the denoiser
+    // filters with the positions and moments that come with the history, whether it is reprojected or not
+    const bool reprojecting = options.reprojection && !headless && !adaptive && options.integrator == reina::tools::Integrator::Megakernel;
+    const bool keepsHistory = reprojecting || denoising;
+    if (keepsHistory) {
+        std::vector<reina::core::Binding> historyBindings = reina::graphics::TemporalHistory::getBindings();
+        rtBindings.insert(rtBindings.end(), historyBindings.begin(), historyBindings.end());
+    }
 
-    reina::graphics::Shader vertexShader = reina::graphics::Shader(logicalDevice, "../shaders/display.vert.spv", VK_SHADER_STAGE_VERTEX_BIT);
-    reina::graphics::Shader fragmentShader = reina::graphics::Shader(logicalDevice, "../shaders/display.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
+    reina::core::DescriptorSet rtDescriptorSet{logicalDevice, rtBindings};
 
-    VkRenderPass renderPass = vktools::createRenderPass(logicalDevice, swapchainObjects.swapchainImageFormat);
-    vktools::PipelineInfo rasterizationPipelineInfo = vktools::createRasterizationPipeline(logicalDevice, rasterizationDescriptorSet, renderPass, vertexShader, fragmentShader);
+    VkCommandPool commandPool = vktools::createCommandPool(physicalDevice, logicalDevice, surface);
+    VkCommandBuffer commandBuffer = vktools::createCommandBuffer(logicalDevice, commandPool);
 
-    std::vector<VkFramebuffer> framebuffers = vktools::createSwapchainFramebuffers(logicalDevice, renderPass, swapchainObjects.swapchainExtent, swapchainImageViews);
+    reina::graphics::Scene scene{logicalDevice, physicalDevice, commandPool, graphicsQueue, options.scenePath, options.optimizeMeshes};
+    const reina::graphics::CameraSettings& cameraSettings = scene.getCamera();
 
-    vertexShader.destroy(logicalDevice);
-    fragmentShader.destroy(logicalDevice);
+    const reina::graphics::Models& sceneModels = scene.getModels();
+    std::cout << "Vertices: " << sceneModels.getVertexCount() << " (" << sceneModels.getVerticesBufferSize() / 1024 << " KiB, "
+              << "max quantization error " << sceneModels.getMaxQuantizationError() << ")\n";
+    std::cout << "Indices: " << sceneModels.getIndicesBufferSize() / 1024 << " KiB\n";
+    std::cout << "Vertex fetch misses per triangle: " << sceneModels.getFetchMissesPerTriangle()
+              << (options.optimizeMeshes ? "" : " (mesh optimization off)") << "\n";
+    std::cout << "BLAS builds: " << scene.getMeshRegistry().getBlasCount() << " in "
+              << scene.getMeshRegistry().getBuildTime() * 1000.0 << " ms\n";
 
-    vktools::SyncObjects syncObjects = vktools::createSyncObjects(logicalDevice);
+    float aspectRatio = static_cast<float>(swapchainObjects.swapchainExtent.width) / static_cast<float>(swapchainObjects.swapchainExtent.height);
+    reina::graphics::Camera camera{renderWindow, glm::radians(cameraSettings.fov), aspectRatio, cameraSettings.position, cameraSettings.direction};
+    reina::core::PushConstants pushConstants{PushConstantsStruct{camera.getInverseView(), camera.getInverseProjection(), glm::mat4(1), 0, benchOptions.seed}, VK_SHADER_STAGE_RAYGEN_BIT_KHR};
 
-    VkCommandPool commandPool = vktools::createCommandPool(physicalDevice, logicalDevice, surface);
-    VkCommandBuffer commandBuffer = vktools::createCommandBuffer(logicalDevice, commandPool);
+    vktools::SbtSpacing sbtSpacing = vktools::calculateSbtSpacing(physicalDevice);
+    reina::graphics::ShaderLoader shaderLoader = options.shaderSourceDirectory.empty()
+            ? reina::graphics::ShaderLoader{}
+            : reina::graphics::ShaderLoader{options.shaderSourceDirectory, options.shaderCacheDirectory};
+
+    // in the order of reina::graphics::Material, first for triangles, then for spheres (see SPHERE_HIT_GROUPS_OFFSET)
+    reina::graphics::RtPipelineDescription rtPipelineDescription{
+            .shaders = {
+                    {adaptive ? "raytrace.adaptive.rgen" : keepsHistory ? "raytrace.reproject.rgen" : "raytrace.rgen", VK_SHADER_STAGE_RAYGEN_BIT_KHR, {enabledAovs}},
+                    {"raytrace.rmiss", VK_SHADER_STAGE_MISS_BIT_KHR},
+                    {"lambertian.rchit", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
+                    {"metal.rchit", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
+                    {"dielectric.rchit", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
+                    {"sphere.rint", VK_SHADER_STAGE_INTERSECTION_BIT_KHR},
+                    {"lambertian.sphere.rchit", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
+                    {"metal.sphere.rchit", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
+                    {"dielectric.sphere.rchit", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR}
+            },
+            .hitGroups = {
+                    {2}, {3}, {4},
+                    {6, 5}, {7, 5}, {8, 5}
+            },
+            .descriptorSet = rtDescriptorSet,
+            .pushConstants = pushConstants,
+            .sbtSpacing = sbtSpacing
+    };
 
-    reina::graphics::Models models{logicalDevice, physicalDevice, {"../models/uv_sphere_highres.obj", "../models/empty_cornell_box.obj", "../models/cornell_light.obj"}};
-    reina::graphics::Blas box{logicalDevice, physicalDevice, commandPool, graphicsQueue, models, models.getModelRange(1)};
-    reina::graphics::Blas light{logicalDevice, physicalDevice, commandPool, graphicsQueue, models, models.getModelRange(2)};
-    reina::graphics::Blas sphere{logicalDevice, physicalDevice, commandPool, graphicsQueue, models, models.getModelRange(0)};
+    // compiling the RT pipeline dominates startup, which the cache from the previous launch mostly skips
+    reina::core::PipelineCache pipelineCache{logicalDevice, physicalDevice, options.pipelineCacheDirectory};
+    auto pipelinesStart = std::chrono::steady_clock::now();
 
-    glm::mat4x4 baseTransform = glm::translate(glm::mat4x4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+    reina::graphics::RtPipeline rtPipeline{logicalDevice, physicalDevice, pipelineCache.getHandle(), shaderLoader, rtPipelineDescription};
 
-    std::vector<reina::graphics::Instance> instances{
-            {box, 0, 0, baseTransform},
-            {light, 1, 0, baseTransform},
-            {sphere, 2, 2, glm::translate(glm::scale(baseTransform, glm::vec3(0.3)), glm::vec3(0, 3, 0))}
-    };
+    std::chrono::duration<double, std::milli> pipelinesTime = std::chrono::steady_clock::now() - pipelinesStart;
+    std::cout << "Pipelines: " << pipelinesTime.count() << " ms ("
+              << (options.pipelineCacheDirectory.empty() ? "no cache" : pipelineCache.isWarm() ? "warm cache" : "cold cache") << ")\n";
 
-    vktools::AccStructureInfo tlas = vktools::createTlas(logicalDevice, physicalDevice, commandPool, graphicsQueue, instances);
+    // only the RT shaders are reloaded, the tone mapper is not worth it. the wavefront kernels aren't rebuilt either, so
+    // watching the sources would only swap a pipeline that doesn't render
+    std::optional<reina::graphics::ShaderReloader> shaderReloader;
+    if (shaderLoader.isCompilingAtRuntime()) {
+        if (options.integrator == reina::tools::Integrator::Wavefront) {
+            std::cout << "Shader hot reload is off with --integrator wavefront\n";
+        } else {
+            shaderReloader.emplace(logicalDevice, physicalDevice, pipelineCache.getHandle(), shaderLoader, rtPipelineDescription);
+        }
+    }
 
-    std::vector<reina::graphics::ObjectProperties> objectProperties{
-            {models.getModelRange(1).indexOffset, glm::vec3{0.9}, glm::vec4(0), 0.2},
-            {models.getModelRange(2).indexOffset, glm::vec3{0.9}, glm::vec4(1, 1, 1, 13), 0},
-            {models.getModelRange(0).indexOffset, glm::vec3(53.0f/255, 196.0f/255, 91.0f/255), glm::vec4(0), 1.5}
-    };
-    reina::core::Buffer objectPropertiesBuffer{
-            logicalDevice, physicalDevice, objectProperties,
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            static_cast<VkMemoryAllocateFlags>(0),
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
-    };
+    vktools::SyncObjects syncObjects = vktools::createSyncObjects(logicalDevice);
 
     // render
     VkDescriptorImageInfo descriptorImageInfo{.imageView = rtImageView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
@@ -180,19 +231,103 @@ void run() {
     VkWriteDescriptorSetAccelerationStructureKHR descriptorAccStructure{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
             .accelerationStructureCount = 1,
-            .pAccelerationStructures = &tlas.accelerationStructure
+            .pAccelerationStructures = &scene.getTlas()
     };
     rtDescriptorSet.writeBinding(logicalDevice, 1, nullptr, nullptr, nullptr, &descriptorAccStructure);
 
-    VkDescriptorBufferInfo verticesInfo{.buffer = models.getVerticesBuffer().getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    VkDescriptorBufferInfo verticesInfo{.buffer = scene.getModels().getVerticesBuffer().getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
     rtDescriptorSet.writeBinding(logicalDevice, 2, nullptr, &verticesInfo, nullptr, nullptr);
 
-    VkDescriptorBufferInfo indicesInfo{.buffer = models.getOffsetIndicesBuffer().getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    VkDescriptorBufferInfo indicesInfo{.buffer = scene.getModels().getIndicesBuffer().getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
     rtDescriptorSet.writeBinding(logicalDevice, 3, nullptr, &indicesInfo, nullptr, nullptr);
 
-    VkDescriptorBufferInfo objPropertiesInfo{.buffer = objectPropertiesBuffer.getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    VkDescriptorBufferInfo objPropertiesInfo{.buffer = scene.getObjectPropertiesBuffer().getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
     rtDescriptorSet.writeBinding(logicalDevice, 4, nullptr, &objPropertiesInfo, nullptr, nullptr);
 
+    VkDescriptorBufferInfo attributesInfo{.buffer = scene.getModels().getAttributesBuffer().getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    rtDescriptorSet.writeBinding(logicalDevice, 5, nullptr, &attributesInfo, nullptr, nullptr);
+
+    VkDescriptorBufferInfo spheresInfo{.buffer = scene.getSpheresBuffer().getHandle(), .offset = 0, .range = VK_WHOLE_SIZE};
+    rtDescriptorSet.writeBinding(logicalDevice, 6, nullptr, &spheresInfo, nullptr, nullptr);
+
+    std::optional<reina::graphics::WavefrontIntegrator> wavefrontIntegrator;
+    if (options.integrator == reina::tools::Integrator::Wavefront) {
+        wavefrontIntegrator.emplace(logicalDevice, physicalDevice, pipelineCache.getHandle(), shaderLoader, rtDescriptorSet,
+                                    swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height);
+    }
+
+    std::optional<reina::graphics::AdaptiveSampler> adaptiveSampler;
+    if (adaptive) {
+        adaptiveSampler.emplace(logicalDevice, physicalDevice, pipelineCache.getHandle(), shaderLoader, rtDescriptorSet,
+                                swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height, options.adaptiveThreshold);
+        adaptiveSampler->writeDescriptors(logicalDevice, rtDescriptorSet);
+    }
+
+    std::optional<reina::graphics::TemporalHistory> temporalHistory;
+    if (keepsHistory) {
+        temporalHistory.emplace(logicalDevice, physicalDevice, swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height);
+        temporalHistory->writeDescriptors(logicalDevice, rtDescriptorSet);
+    }
+
+    reina::graphics::AovImages aovImages{logicalDevice, physicalDevice, swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height, enabledAovs};
+    aovImages.writeDescriptors(logicalDevice, rtDescriptorSet);
+
+    reina::graphics::Accumulator accumulator{logicalDevice, physicalDevice, pipelineCache.getHandle(), shaderLoader, rtDescriptorSet,
+                                             swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height};
+    accumulator.writeDescriptors(logicalDevice, rtDescriptorSet);
+
+    std::optional<reina::graphics::Denoiser> denoiser;
+    if (denoising) {
+        denoiser.emplace(logicalDevice, physicalDevice, pipelineCache.getHandle(), shaderLoader, rtDescriptorSet, accumulator.getDisplayView(),
+                         swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height, options.denoiseIterations);
+    }
+
+    // the benchmark reads the accumulation image itself, so only the window is tonemapped
+    std::optional<reina::graphics::ToneMapper> toneMapper;
+    if (!headless) {
+        toneMapper.emplace(logicalDevice, physicalDevice, pipelineCache.getHandle(), shaderLoader, accumulator.getDisplayView(),
+                           swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height);
+    }
+
+    // every pipeline exists now, so a crash while rendering still leaves a warm cache for the next launch
+    pipelineCache.save(logicalDevice);
+
+    reina::graphics::ImageExporter imageExporter{logicalDevice, physicalDevice, indices.graphicsFamily.value(), indices.transferFamily.value(),
+                                                 transferQueue, rtImageObjects.image, accumulator.getCompensationImage(),
+                                                 toneMapper.has_value() ? toneMapper->getExposureBuffer() : VK_NULL_HANDLE,
+                                                 swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height};
+    uint32_t exportCount = 0;
+    bool exportKeyWasDown = false;
+
+    // the benchmark needs the same samples on every run, so it doesn't adapt to the frame time
+    const VkExtent2D& extent = swapchainObjects.swapchainExtent;
+    reina::graphics::SampleScheduler sampleScheduler{extent.width, extent.height, headless ? 0 : options.frameBudgetMs / 1000.0,
+                                                    !wavefrontIntegrator.has_value() && !adaptive, headless ? 0 : options.targetSamples};
+    reina::core::GpuTimer gpuTimer{logicalDevice, physicalDevice};
+
+    const VkPipelineStageFlagBits tracingStage = wavefrontIntegrator.has_value()
+            ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+            : VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
+
+    std::optional<reina::tools::Bench> bench;
+    std::optional<reina::tools::HostImage> benchImage;
+    if (headless) {
+        bench.emplace(benchOptions);
+        bench->start();
+    }
+
+    bool rtImageInitialized = false;
+    bool traced = false;
+    bool tracedWorkList = false;
+    bool idling = false;
+
+    // the wavefront integrator always traces at full resolution
+    const bool previewEnabled = options.preview && !headless && !wavefrontIntegrator.has_value();
+    double lastCameraMove = -consts::PREVIEW_HOLD_TIME;
+    bool previewing = false;
+    bool reprojectHistory = false;  // until the first pass after the camera moved is complete
+    bool historyCopyPending = false;
+
     reina::tools::Clock clock;
     while (!renderWindow.shouldClose()) {
         // camera
@@ -200,15 +335,37 @@ void run() {
         if (camera.hasChanged()) {
             camera.refresh();
             PushConstantsStruct& pushConstantsStruct = pushConstants.getPushConstants();
+            pushConstantsStruct.previousViewProjection = glm::inverse(pushConstantsStruct.invView * pushConstantsStruct.invProjection);
             pushConstantsStruct.invView = camera.getInverseView();
             pushConstantsStruct.invProjection = camera.getInverseProjection();
-            pushConstantsStruct.sampleBatch = 0;  // reset the image
+            lastCameraMove = glfwGetTime();
+
+            if (reprojecting) {
+                sampleScheduler.reproject();
+                reprojectHistory = true;
+                historyCopyPending = true;
+            } else {
+                sampleScheduler.reset();
+            }
+        }
+
+        // mouse input doesn't arrive every frame, so the preview lasts a little longer than the movement. with
+        // reprojection, full quality frames are only replaced when a whole pass doesn't fit the budget
+        const bool wasPreviewing = previewing;
+        previewing = previewEnabled && glfwGetTime() - lastCameraMove < consts::PREVIEW_HOLD_TIME
+                && (!reprojecting || !sampleScheduler.fitsFullPass());
+        if (previewing || wasPreviewing) {
+            reprojectHistory = false;  // the preview isn't accumulated, so there is nothing to reproject
+            historyCopyPending = false;
+        }
+        if (wasPreviewing && !previewing) {
+            sampleScheduler.reset();  // the full quality image starts over the last preview
         }
 
         // clock
         bool firstFrame = clock.getFrameCount() == 0;
 
-        if (!firstFrame) {
+        if (!firstFrame && !headless && !idling) {
              std::cout << clock.summary() << "\n";
         }
 
@@ -224,79 +381,200 @@ void run() {
             throw std::runtime_error("Could not reset fences");
         }
 
-        VkCommandBufferBeginInfo beginInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
-            throw std::runtime_error("Could not begin command buffer");
+        // the previous frame has finished, so its samples can be counted
+        uint32_t listedPixels = tracedWorkList ? adaptiveSampler->getListedPixels(logicalDevice) : 0;
+        uint64_t tracedPixelSamples = !traced ? 0
+                : tracedWorkList ? static_cast<uint64_t>(listedPixels) * pushConstants.getPushConstants().samplesPerPixel
+                : sampleScheduler.getLastPixelSamples();
+        clock.addSamples(tracedPixelSamples, static_cast<uint64_t>(extent.width) * extent.height);
+
+        // an empty work list means every pixel is below the noise threshold
+        if (tracedWorkList && listedPixels == 0) {
+            sampleScheduler.markConverged();
         }
 
-        transitionImage(
-                commandBuffer,
-                rtImageObjects.image,
-                firstFrame ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_GENERAL,
-                VK_IMAGE_LAYOUT_GENERAL,
-                firstFrame ? static_cast<VkAccessFlagBits>(0) : VK_ACCESS_SHADER_READ_BIT,
-                VK_ACCESS_SHADER_WRITE_BIT,
-                firstFrame ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR
-        );
+        if (std::optional<double> frameTime = gpuTimer.read(logicalDevice)) {
+            sampleScheduler.reportTime(frameTime.value(), tracedPixelSamples);
+        }
 
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rtPipelineInfo.pipeline);
+        // the fence wait above means the GPU is done with the current pipeline
+        if (shaderReloader.has_value()) {
+            if (std::optional<reina::graphics::RtPipeline> rebuilt = shaderReloader->takeRebuilt()) {
+                rtPipeline.destroy(logicalDevice);
+                rtPipeline = std::move(rebuilt.value());
+                sampleScheduler.reset();  // the old samples were shaded differently
+                reprojectHistory = false;
+                historyCopyPending = false;
+            }
+        }
 
-        rtDescriptorSet.bind(commandBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rtPipelineInfo.pipelineLayout);
+        VkCommandBufferBeginInfo beginInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("Could not begin command buffer");
+        }
 
-        pushConstants.push(commandBuffer, rtPipelineInfo.pipelineLayout);
-        pushConstants.getPushConstants().sampleBatch++;
+        // a finished image is only presented again, which leaves the GPU to others. the benchmark runs to its own spp
+        const bool idle = !headless && sampleScheduler.isFinished();
+        traced = !idle;
+        tracedWorkList = false;
+
+        if (!idle) {
+            reina::graphics::SamplePlan samplePlan = previewing ? sampleScheduler.nextPreview() : sampleScheduler.next();
+            PushConstantsStruct& frameConstants = pushConstants.getPushConstants();
+            frameConstants.sampleBatch = samplePlan.sampleBatch;
+            frameConstants.samplesPerPixel = samplePlan.samplesPerPixel;
+            frameConstants.accumulatedSamples = samplePlan.accumulatedSamples;
+            frameConstants.firstRow = samplePlan.firstRow;
+            frameConstants.bounces = samplePlan.bounces;
+            frameConstants.previewScale = samplePlan.previewScale;
+
+            if (samplePlan.accumulatedSamples > 0) {
+                reprojectHistory = false;
+            }
+            frameConstants.reproject = reprojectHistory ? 1 : 0;
+
+            gpuTimer.begin(commandBuffer);
+
+            // the clock only counts a frame once two have been marked, so it can't tell if the image was initialized
+            transitionImage(
+                    commandBuffer,
+                    rtImageObjects.image,
+                    !rtImageInitialized ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    !rtImageInitialized ? static_cast<VkAccessFlagBits>(0) : VK_ACCESS_SHADER_READ_BIT,
+                    VK_ACCESS_SHADER_WRITE_BIT,
+                    !rtImageInitialized ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    tracingStage
+            );
+
+            if (!rtImageInitialized && adaptiveSampler.has_value()) {
+                adaptiveSampler->recordInitialization(commandBuffer);
+            }
+            if (!rtImageInitialized && temporalHistory.has_value()) {
+                temporalHistory->recordInitialization(commandBuffer);
+            }
+            if (!rtImageInitialized && denoiser.has_value()) {
+                denoiser->recordInitialization(commandBuffer);
+            }
+            if (!rtImageInitialized) {
+                aovImages.recordInitialization(commandBuffer);
+                accumulator.recordInitialization(commandBuffer);
+            }
+            if (!rtImageInitialized && toneMapper.has_value()) {
+                toneMapper->recordInitialization(commandBuffer);
+            }
+            rtImageInitialized = true;
 
-        VkStridedDeviceAddressRegionKHR sbtRayGenRegion, sbtMissRegion, sbtHitRegion, sbtCallableRegion;
-        VkDeviceAddress sbtStartAddress = getBufferDeviceAddress(logicalDevice, sbtBuffer.getHandle());
+            if (historyCopyPending) {
+                temporalHistory->recordCopy(commandBuffer, rtImageObjects.image, accumulator.getCompensationImage());
+                historyCopyPending = false;
+            }
 
-        sbtRayGenRegion.deviceAddress = sbtStartAddress;
-        sbtRayGenRegion.stride = sbtSpacing.stride;
-        sbtRayGenRegion.size = sbtSpacing.stride;
+            // after a reset every pixel is traced once, which starts their moments over
+            tracedWorkList = adaptiveSampler.has_value() && samplePlan.accumulatedSamples > 0;
+            if (tracedWorkList) {
+                adaptiveSampler->recordSelection(commandBuffer, rtDescriptorSet);
+            }
 
-        sbtMissRegion = sbtRayGenRegion;
-        sbtMissRegion.deviceAddress = sbtStartAddress + sbtSpacing.stride;
-        sbtMissRegion.size = sbtSpacing.stride;
+            if (wavefrontIntegrator.has_value()) {
+                wavefrontIntegrator->record(commandBuffer, rtDescriptorSet, frameConstants);
+            } else {
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rtPipeline.getPipeline());
+
+                rtDescriptorSet.bind(commandBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rtPipeline.getLayout());
+
+                pushConstants.push(commandBuffer, rtPipeline.getLayout());
+
+                VkStridedDeviceAddressRegionKHR sbtRayGenRegion, sbtMissRegion, sbtHitRegion, sbtCallableRegion;
+                VkDeviceAddress sbtStartAddress = getBufferDeviceAddress(logicalDevice, rtPipeline.getSbt().getHandle());
+
+                sbtRayGenRegion.deviceAddress = sbtStartAddress;
+                sbtRayGenRegion.stride = sbtSpacing.stride;
+                sbtRayGenRegion.size = sbtSpacing.stride;
+
+                sbtMissRegion = sbtRayGenRegion;
+                sbtMissRegion.deviceAddress = sbtStartAddress + sbtSpacing.stride;
+                sbtMissRegion.size = sbtSpacing.stride;
+
+                sbtHitRegion = sbtRayGenRegion;
+                sbtHitRegion.deviceAddress = sbtStartAddress + 2 * sbtSpacing.stride;
+                sbtHitRegion.size = sbtSpacing.stride * rtPipelineDescription.hitGroups.size();
+
+                sbtCallableRegion = sbtRayGenRegion;
+                sbtCallableRegion.size = 0;
+
+                auto vkCmdTraceRaysKHR = reinterpret_cast<PFN_vkCmdTraceRaysKHR>(
+                        vkGetDeviceProcAddr(logicalDevice, "vkCmdTraceRaysKHR"));
+
+                if (!vkCmdTraceRaysKHR) {
+                    throw std::runtime_error("Failed to load vkCmdTraceRaysKHR");
+                }
+
+                if (tracedWorkList) {
+                    auto vkCmdTraceRaysIndirectKHR = reinterpret_cast<PFN_vkCmdTraceRaysIndirectKHR>(
+                            vkGetDeviceProcAddr(logicalDevice, "vkCmdTraceRaysIndirectKHR"));
+
+                    if (!vkCmdTraceRaysIndirectKHR) {
+                        throw std::runtime_error("Failed to load vkCmdTraceRaysIndirectKHR");
+                    }
+
+                    vkCmdTraceRaysIndirectKHR(
+                            commandBuffer,
+                            &sbtRayGenRegion,
+                            &sbtMissRegion,
+                            &sbtHitRegion,
+                            &sbtCallableRegion,
+                            adaptiveSampler->getTraceCommandAddress(logicalDevice)
+                    );
+
+                    adaptiveSampler->recordReadback(commandBuffer);
+                } else {
+                    vkCmdTraceRaysKHR(
+                            commandBuffer,
+                            &sbtRayGenRegion,
+                            &sbtMissRegion,
+                            &sbtHitRegion,
+                            &sbtCallableRegion,
+                            (extent.width + samplePlan.previewScale - 1) / samplePlan.previewScale,
+                            (samplePlan.rowCount + samplePlan.previewScale - 1) / samplePlan.previewScale,
+                            1
+                    );
+                }
+            }
 
-        sbtHitRegion = sbtRayGenRegion;
-        sbtHitRegion.deviceAddress = sbtStartAddress + 2 * sbtSpacing.stride;
-        sbtHitRegion.size = sbtSpacing.stride * (shaders.size() - 2);  // assuming shaders vector includes 2 non-rchit shaders
+            // the preview's features are only those of the top left pixel of each block. either pass synchronizes the
+            // sums with itself and the display image with the tone mapper
+            if (denoiser.has_value() && samplePlan.previewScale == 1) {
+                denoiser->record(commandBuffer, rtDescriptorSet);
+            } else {
+                accumulator.recordResolve(commandBuffer, rtDescriptorSet);
+            }
 
-        sbtCallableRegion = sbtRayGenRegion;
-        sbtCallableRegion.size = 0;
+            // the denoiser and the resolve run every traced frame, so they take from the frame budget too
+            gpuTimer.end(commandBuffer);
+        }
 
-        auto vkCmdTraceRaysKHR = reinterpret_cast<PFN_vkCmdTraceRaysKHR>(
-                vkGetDeviceProcAddr(logicalDevice, "vkCmdTraceRaysKHR"));
+        // F12 captures once per press. the copy is recorded after everything that writes the sums this frame
+        const bool exportKeyDown = !headless && renderWindow.keyPressed(GLFW_KEY_F12);
+        if (rtImageInitialized && (options.exportEveryFrame || (exportKeyDown && !exportKeyWasDown))) {
+            std::ostringstream filepath;
+            filepath << options.exportPrefix << "." << std::setw(5) << std::setfill('0') << exportCount << "." << options.exportFormat;
 
-        if (!vkCmdTraceRaysKHR) {
-            throw std::runtime_error("Failed to load vkCmdTraceRaysKHR");
+            if (imageExporter.recordCapture(commandBuffer, filepath.str())) {
+                exportCount++;
+            } else {
+                std::cerr << "Capture dropped, every export slot is still busy\n";
+            }
         }
-
-        vkCmdTraceRaysKHR(
-                commandBuffer,
-                &sbtRayGenRegion,
-                &sbtMissRegion,
-                &sbtHitRegion,
-                &sbtCallableRegion,
-                swapchainObjects.swapchainExtent.width,
-                swapchainObjects.swapchainExtent.height,
-                1
-        );
+        exportKeyWasDown = exportKeyDown;
 
         // everything below here is swapchain stuff
         clock.markCategory("Display");
 
-        // transition to the same and synchronize
-        transitionImage(
-                commandBuffer,
-                rtImageObjects.image,
-                VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
-                VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
-        );
+        const bool presenting = !headless && !renderWindow.isMinimized();
 
         uint32_t imageIndex = -1;
-        if (!renderWindow.isMinimized()) {
+        if (presenting) {
             VkResult result = vkAcquireNextImageKHR(logicalDevice, swapchainObjects.swapchain, UINT64_MAX, syncObjects.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
 
             if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
@@ -306,49 +584,9 @@ void run() {
             }
         }
 
-        if (!renderWindow.isMinimized()) {
-            VkClearValue clearColor = {{0, 0, 0, 1}};
-
-            VkRenderPassBeginInfo renderPassBeginInfo{
-                .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-                .renderPass = renderPass,
-                .framebuffer = framebuffers[imageIndex],
-                .renderArea = {
-                        .offset = {0, 0},
-                        .extent = swapchainObjects.swapchainExtent
-                },
-                .clearValueCount = 1,
-                .pClearValues = &clearColor
-            };
-
-            vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-            VkDescriptorImageInfo readImageInfo{.imageView = rtImageView, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
-
-            rasterizationDescriptorSet.bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, rasterizationPipelineInfo.pipelineLayout);
-            rasterizationDescriptorSet.writeBinding(logicalDevice, 0, &readImageInfo, nullptr, nullptr, nullptr);
-
-            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, rasterizationPipelineInfo.pipeline);
-
-            VkViewport viewport{
-                .x = 0,
-                .y = 0,
-                .width = static_cast<float>(swapchainObjects.swapchainExtent.width),
-                .height = static_cast<float>(swapchainObjects.swapchainExtent.height),
-                .minDepth = 0,
-                .maxDepth = 1
-            };
-            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-            VkRect2D scissor{
-                .offset = {0, 0},
-                .extent = swapchainObjects.swapchainExtent
-            };
-            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-            vkCmdDraw(commandBuffer, 6, 1, 0, 0);
-
-            vkCmdEndRenderPass(commandBuffer);
+        if (presenting) {
+            toneMapper->record(commandBuffer, swapchainObjects.swapchainImages[imageIndex], swapchainObjects.swapchainExtent,
+                               static_cast<float>(clock.getTimeDelta()));
         }
 
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
@@ -360,28 +598,47 @@ void run() {
 
         VkSemaphore waitSemaphores[] = {syncObjects.imageAvailableSemaphore};
         VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT};
-        submitInfo.waitSemaphoreCount = renderWindow.isMinimized() ? 0 : 1;
-        submitInfo.pWaitSemaphores = renderWindow.isMinimized() ? VK_NULL_HANDLE : waitSemaphores;
+        submitInfo.waitSemaphoreCount = presenting ? 1 : 0;
+        submitInfo.pWaitSemaphores = presenting ? waitSemaphores : VK_NULL_HANDLE;
         submitInfo.pWaitDstStageMask = waitStages;
 
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
 
-        VkSemaphore signalSemaphores[] = {syncObjects.renderFinishedSemaphore};
-        submitInfo.signalSemaphoreCount = renderWindow.isMinimized() ? 0 : 1;
-        submitInfo.pSignalSemaphores = renderWindow.isMinimized() ? VK_NULL_HANDLE : signalSemaphores;
+        // a capture's copy signals one of the export timelines. binary semaphores ignore their value
+        std::vector<VkSemaphore> signalSemaphores;
+        std::vector<uint64_t> signalValues;
+        if (presenting) {
+            signalSemaphores.push_back(syncObjects.renderFinishedSemaphore);
+            signalValues.push_back(0);
+        }
+        if (std::optional<reina::graphics::ImageExporter::TimelineSignal> exportSignal = imageExporter.getFrameSignal()) {
+            signalSemaphores.push_back(exportSignal->semaphore);
+            signalValues.push_back(exportSignal->value);
+        }
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size()),
+            .pSignalSemaphoreValues = signalValues.data()
+        };
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+        submitInfo.pSignalSemaphores = signalSemaphores.data();
 
         if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, syncObjects.inFlightFence) != VK_SUCCESS) {
             throw std::runtime_error("Could not submit graphics queue");
         }
 
+        imageExporter.submit();
+
         // Present the swapchain image
-        if (!renderWindow.isMinimized()) {
+        if (presenting) {
             VkPresentInfoKHR presentInfo{};
             presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
             presentInfo.waitSemaphoreCount = 1;
-            presentInfo.pWaitSemaphores = signalSemaphores;
+            presentInfo.pWaitSemaphores = &syncObjects.renderFinishedSemaphore;
 
             presentInfo.swapchainCount = 1;
             presentInfo.pSwapchains = &swapchainObjects.swapchain;
@@ -390,53 +647,100 @@ void run() {
             vkQueuePresentKHR(presentQueue, &presentInfo);
         }
 
-        glfwPollEvents();
+        // while idle, only input or the timeout (to present again) wakes the loop
+        if (sampleScheduler.isFinished() && !headless) {
+            if (!idling) {
+                std::cout << "Finished at " << sampleScheduler.getAccumulatedSamples() << " spp, idling until the view changes\n";
+            }
+
+            idling = true;
+            glfwWaitEventsTimeout(consts::IDLE_PRESENT_INTERVAL);
+        } else {
+            idling = false;
+            glfwPollEvents();
+        }
+
+        if (bench.has_value()) {
+            uint32_t samples = sampleScheduler.getAccumulatedSamples();
+
+            if (bench->wantsCheckpoint(samples)) {
+                // the frame still in flight is render time, only the readback isn't
+                if (vkWaitForFences(logicalDevice, 1, &syncObjects.inFlightFence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
+                    throw std::runtime_error("Could not wait for fences");
+                }
+
+                bench->pause();
+
+                reina::tools::HostImage image = vktools::readRtImage(
+                        logicalDevice, physicalDevice, commandPool, graphicsQueue, rtImageObjects.image,
+                        swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height
+                );
+                if (COMPENSATED_ACCUMULATION) {
+                    reina::tools::HostImage compensation = vktools::readRtImage(
+                            logicalDevice, physicalDevice, commandPool, graphicsQueue, accumulator.getCompensationImage(),
+                            swapchainObjects.swapchainExtent.width, swapchainObjects.swapchainExtent.height
+                    );
+                    reina::tools::resolveAccumulation(image, &compensation);
+                } else {
+                    reina::tools::resolveAccumulation(image);
+                }
+                bench->checkpoint(samples, image);
+
+                if (bench->isFinished(samples)) {
+                    if (!benchOptions.aovOutputPrefix.empty()) {
+                        aovImages.write(logicalDevice, physicalDevice, commandPool, graphicsQueue, benchOptions.aovOutputPrefix);
+                    }
+
+                    benchImage = std::move(image);
+                    break;
+                }
+            }
+        }
     }
 
     vkDeviceWaitIdle(logicalDevice);
 
-    // clean up
-    auto vkDestroyAccelerationStructureKHR = reinterpret_cast<PFN_vkDestroyAccelerationStructureKHR>(
-            vkGetDeviceProcAddr(logicalDevice, "vkDestroyAccelerationStructureKHR"));
-
-    if (!vkDestroyAccelerationStructureKHR) {
-        throw std::runtime_error("Destroy acceleration structure function cannot be found");
+    if (shaderReloader.has_value()) {
+        shaderReloader->destroy(logicalDevice);
     }
 
-    for (VkFramebuffer framebuffer : framebuffers) {
-        vkDestroyFramebuffer(logicalDevice, framebuffer, nullptr);
+    // clean up
+    scene.destroy(logicalDevice);
+    rtPipeline.destroy(logicalDevice);
+    gpuTimer.destroy(logicalDevice);
+    if (adaptiveSampler.has_value()) {
+        adaptiveSampler->destroy(logicalDevice);
     }
-
-    light.destroy(logicalDevice);
-    box.destroy(logicalDevice);
-    sphere.destroy(logicalDevice);
-    tlas.buffer.destroy(logicalDevice);
-    sbtBuffer.destroy(logicalDevice);
-    objectPropertiesBuffer.destroy(logicalDevice);
+    if (temporalHistory.has_value()) {
+        temporalHistory->destroy(logicalDevice);
+    }
+    if (denoiser.has_value()) {
+        denoiser->destroy(logicalDevice);
+    }
+    aovImages.destroy(logicalDevice);
+    accumulator.destroy(logicalDevice);
+    imageExporter.destroy(logicalDevice);
+    if (toneMapper.has_value()) {
+        toneMapper->destroy(logicalDevice);
+    }
+    if (wavefrontIntegrator.has_value()) {
+        wavefrontIntegrator->destroy(logicalDevice);
+    }
+    // again on shutdown, to keep the pipelines the shader reloader compiled
+    pipelineCache.save(logicalDevice);
+    pipelineCache.destroy(logicalDevice);
 
     vkFreeCommandBuffers(logicalDevice, commandPool, 1, &commandBuffer);
-    vkDestroyRenderPass(logicalDevice, renderPass, nullptr);
-    vkDestroyAccelerationStructureKHR(logicalDevice, tlas.accelerationStructure, nullptr);
     rtDescriptorSet.destroy(logicalDevice);
-    rasterizationDescriptorSet.destroy(logicalDevice);
     vkDestroySemaphore(logicalDevice, syncObjects.renderFinishedSemaphore, nullptr);
     vkDestroySemaphore(logicalDevice, syncObjects.imageAvailableSemaphore, nullptr);
     vkDestroyFence(logicalDevice, syncObjects.inFlightFence, nullptr);
-    models.destroy(logicalDevice);
-    vkDestroyPipeline(logicalDevice, rtPipelineInfo.pipeline, nullptr);
-    vkDestroyPipeline(logicalDevice, rasterizationPipelineInfo.pipeline, nullptr);
-    vkDestroyPipelineLayout(logicalDevice, rtPipelineInfo.pipelineLayout, nullptr);
-    vkDestroyPipelineLayout(logicalDevice, rasterizationPipelineInfo.pipelineLayout, nullptr);
     vkDestroyImageView(logicalDevice, rtImageView, nullptr);
     vkDestroyImage(logicalDevice, rtImageObjects.image, nullptr);
     vkFreeMemory(logicalDevice, rtImageObjects.imageMemory, nullptr);
 
     vkDestroyCommandPool(logicalDevice, commandPool, nullptr);
 
-    for (VkImageView imageView : swapchainImageViews) {
-        vkDestroyImageView(logicalDevice, imageView, nullptr);
-    }
-
     vkDestroySwapchainKHR(logicalDevice, swapchainObjects.swapchain, nullptr);
 
     vkDestroyDevice(logicalDevice, nullptr);
@@ -448,12 +752,25 @@ void run() {
     vkDestroySurfaceKHR(instance, surface, nullptr);
     vkDestroyInstance(instance, nullptr);
     renderWindow.destroy();
+
+    if (bench.has_value() && benchImage.has_value()) {
+        std::cout << bench->summary();
+        bench->finish(benchImage.value());
+    }
 }
 
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
-        run();
+        reina::tools::Options options = reina::tools::parseOptions(argc, argv);
+
+        // CPU only, so it doesn't need a window or device
+        if (!options.objBenchPath.empty()) {
+            std::cout << reina::graphics::benchmarkObjParsers(options.objBenchPath);
+            return 0;
+        }
+
+        run(options);
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
         return 1;
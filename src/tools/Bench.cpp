@@ -0,0 +1,140 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "Clock.h"
+
+double reina::tools::tonemappedRmse(const HostImage& image, const HostImage& reference) {
+    if (image.width != reference.width || image.height != reference.height) {
+        throw std::runtime_error("Cannot compare images of different sizes");
+    }
+
+    double squaredErrorSum = 0;
+    size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+
+    for (size_t pixel = 0; pixel < pixelCount; pixel++) {
+        for (size_t channel = 0; channel < 3; channel++) {
+            double difference = tonemapACES(image.pixels[pixel * 4 + channel]) - tonemapACES(reference.pixels[pixel * 4 + channel]);
+            squaredErrorSum += difference * difference;
+        }
+    }
+
+    return std::sqrt(squaredErrorSum / static_cast<double>(pixelCount * 3));
+}
+
+reina::tools::Bench::Bench(BenchOptions options) : options(std::move(options)) {
+    const BenchOptions& opts = this->options;
+
+    if (!opts.referencePath.empty() && !opts.updateReference) {
+        reference = readPfm(opts.referencePath);
+
+        if (reference->width != opts.width || reference->height != opts.height) {
+            throw std::runtime_error("Reference image " + opts.referencePath + " does not match the benchmark resolution");
+        }
+    }
+
+    if ((opts.targetRmse > 0 || opts.maxRmse > 0) && !reference.has_value()) {
+        throw std::runtime_error("Error thresholds need a reference image to compare against");
+    }
+}
+
+const reina::tools::BenchOptions& reina::tools::Bench::getOptions() const {
+    return options;
+}
+
+bool reina::tools::Bench::isFinished(uint32_t samples) const {
+    return samples >= options.samplesPerPixel;
+}
+
+bool reina::tools::Bench::wantsCheckpoint(uint32_t samples) const {
+    // the final image is always read back for the output files, intermediate ones only when there's something to compare
+    if (isFinished(samples)) {
+        return true;
+    }
+
+    return reference.has_value() && samples - lastCheckpointSamples >= options.checkInterval;
+}
+
+void reina::tools::Bench::start() {
+    renderSeconds = 0;
+    resumeTime = Clock::getTime();
+}
+
+void reina::tools::Bench::pause() {
+    renderSeconds += Clock::getTime() - resumeTime;
+}
+
+void reina::tools::Bench::checkpoint(uint32_t samples, const HostImage& image) {
+    BenchCheckpoint checkpoint{samples, renderSeconds, std::nullopt};
+
+    if (reference.has_value()) {
+        checkpoint.rmse = tonemappedRmse(image, reference.value());
+
+        if (!targetReached.has_value() && options.targetRmse > 0 && checkpoint.rmse.value() <= options.targetRmse) {
+            targetReached = checkpoint;
+        }
+    }
+
+    checkpoints.push_back(checkpoint);
+    lastCheckpointSamples = samples;
+    resumeTime = Clock::getTime();
+}
+
+void reina::tools::Bench::finish(const HostImage& image) {
+    if (!options.outputPath.empty()) {
+        writePfm(options.outputPath, image);
+    }
+
+    if (options.updateReference) {
+        std::filesystem::path referenceDir = std::filesystem::path(options.referencePath).parent_path();
+        if (!referenceDir.empty()) {
+            std::filesystem::create_directories(referenceDir);
+        }
+
+        writePfm(options.referencePath, image);
+        return;
+    }
+
+    if (checkpoints.empty() || !checkpoints.back().rmse.has_value()) {
+        return;
+    }
+
+    double finalRmse = checkpoints.back().rmse.value();
+    if (options.maxRmse > 0 && finalRmse > options.maxRmse) {
+        throw std::runtime_error("Convergence regression: final RMSE " + std::to_string(finalRmse) + " exceeds " + std::to_string(options.maxRmse));
+    }
+
+    if (options.targetRmse > 0 && !targetReached.has_value()) {
+        throw std::runtime_error("Convergence regression: target RMSE " + std::to_string(options.targetRmse) + " was never reached");
+    }
+
+    if (options.maxTimeToTarget > 0 && targetReached.has_value() && targetReached->renderSeconds > options.maxTimeToTarget) {
+        throw std::runtime_error("Performance regression: reaching the target RMSE took " + std::to_string(targetReached->renderSeconds) + "s");
+    }
+}
+
+std::string reina::tools::Bench::summary() const {
+    std::ostringstream oss;
+    oss << "Benchmark " << options.width << "x" << options.height << ", " << options.samplesPerPixel << " spp, seed " << options.seed << "\n";
+
+    for (const BenchCheckpoint& checkpoint : checkpoints) {
+        oss << "  " << checkpoint.samples << " spp | " << checkpoint.renderSeconds * 1000 << "ms";
+        if (checkpoint.rmse.has_value()) {
+            oss << " | RMSE " << checkpoint.rmse.value();
+        }
+        oss << "\n";
+    }
+
+    if (targetReached.has_value()) {
+        oss << "Time to RMSE " << options.targetRmse << ": " << targetReached->renderSeconds * 1000 << "ms (" << targetReached->samples << " spp)\n";
+    } else if (options.targetRmse > 0) {
+        oss << "Target RMSE " << options.targetRmse << " not reached\n";
+    }
+
+    return oss.str();
+}
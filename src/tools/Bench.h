@@ -0,0 +1,71 @@
+#ifndef REINA_VK_BENCH_H
+#define REINA_VK_BENCH_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Options.h"
+#include "ImageIO.h"
+
+namespace reina::tools {
+    struct BenchCheckpoint {
+        uint32_t samples;
+        double renderSeconds;
+        std::optional<double> rmse;
+    };
+
+    /**
+     * Drives a headless render to a fixed sample count and compares it against a stored reference. The image is read
+     * back every few samples, so both the final error (convergence regressions, e.g. from a sampler change) and the
+     * time needed to reach a target error (performance regressions) come out of one run. Time spent on readbacks and
+     * comparisons is excluded from the render time.
+     */
+    class Bench {
+    public:
+        explicit Bench(BenchOptions options);
+
+        [[nodiscard]] const BenchOptions& getOptions() const;
+
+        [[nodiscard]] bool isFinished(uint32_t samples) const;
+        [[nodiscard]] bool wantsCheckpoint(uint32_t samples) const;
+
+        void start();
+
+        /**
+         * Stops the render timer. Call once the frames in flight have finished, before the readback.
+         */
+        void pause();
+
+        /**
+         * Records the error of the read back image and resumes the render timer.
+         */
+        void checkpoint(uint32_t samples, const HostImage& image);
+
+        /**
+         * Writes the output and reference images if requested. Throws if the error or time thresholds are exceeded.
+         */
+        void finish(const HostImage& image);
+
+        [[nodiscard]] std::string summary() const;
+
+    private:
+        BenchOptions options;
+        std::optional<HostImage> reference;
+
+        double renderSeconds = 0;
+        double resumeTime = 0;
+        uint32_t lastCheckpointSamples = 0;
+
+        std::vector<BenchCheckpoint> checkpoints;
+        std::optional<BenchCheckpoint> targetReached;
+    };
+
+    /**
+     * Root mean square error between two images after the same ACES tonemapping as tonemap.apply.comp, but without its
+     * auto exposure, so that very bright pixels like the light source do not dominate the result.
+     */
+    [[nodiscard]] double tonemappedRmse(const HostImage& image, const HostImage& reference);
+}
+
+#endif //REINA_VK_BENCH_H
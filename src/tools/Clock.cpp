@@ -1,7 +1,6 @@
 #include "Clock.h"
 
 #include <sstream>
-#include "../../polyglot/common.h"
 
 void reina::tools::TimeEntries::addEntry(double timing) {
     if (recordings == 0) {
@@ -34,6 +33,11 @@ void reina::tools::Clock::markFrame() {
 
     double time = getTime();
     frameTime.addEntry(time - lastFrameTime);
+    if (sampledThisFrame) {
+        samplingTime += time - lastFrameTime;
+        sampledThisFrame = false;
+    }
+
     secondToLastFrameTime = lastFrameTime;
     lastFrameTime = time;
 }
@@ -55,12 +59,18 @@ void reina::tools::Clock::markCategory(const std::string& category) {
     lastCategoryRecording = time;
 }
 
+void reina::tools::Clock::addSamples(uint64_t pixelSamples, uint64_t pixelCount) {
+    this->pixelSamples += pixelSamples;
+    samplesPerPixel += static_cast<double>(pixelSamples) / static_cast<double>(pixelCount);
+    sampledThisFrame = sampledThisFrame || pixelSamples > 0;
+}
+
 std::string reina::tools::Clock::summary() {
     std::ostringstream oss;
     oss << "Timer age: " << getTimeFromCreation() << "s\n";
     oss << "Samples: " << getSampleCount() << "\n";
     oss << "Average frame time: " << frameTime.averageTime * 1000 << "ms\n";
-    oss << "Average time per spp: " << frameTime.averageTime * 1000 / SAMPLES_PER_PIXEL << "ms\n";
+    oss << "Samples per second: " << getSamplesPerSecond() / 1e6 << "M\n";
 
     for (auto & time : categoryTimes) {
         oss << "Average category time | " << time.first << ": " << time.second.averageTime * 1000 << "ms\n";
@@ -74,7 +84,11 @@ unsigned int reina::tools::Clock::getFrameCount() const {
 }
 
 unsigned int reina::tools::Clock::getSampleCount() const {
-    return getFrameCount() * SAMPLES_PER_PIXEL;
+    return static_cast<unsigned int>(samplesPerPixel);
+}
+
+double reina::tools::Clock::getSamplesPerSecond() const {
+    return samplingTime > 0 ? static_cast<double>(pixelSamples) / samplingTime : 0;
 }
 
 double reina::tools::Clock::getAverageFrameTime() const {
@@ -1,6 +1,7 @@
 #ifndef REINA_VK_CLOCK_H
 #define REINA_VK_CLOCK_H
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -29,8 +30,14 @@ namespace reina::tools {
         void markFrame();
         void markCategory(const std::string& category);
 
+        /**
+         * Counts samples traced for the image, for the samples per second in the summary.
+         */
+        void addSamples(uint64_t pixelSamples, uint64_t pixelCount);
+
         [[nodiscard]] unsigned int getFrameCount() const;
-        [[nodiscard]] unsigned int getSampleCount() const;
+        [[nodiscard]] unsigned int getSampleCount() const;  // per pixel
+        [[nodiscard]] double getSamplesPerSecond() const;   // pixel samples, averaged over the frames that traced any
 
         [[nodiscard]] double getAverageFrameTime() const;
         [[nodiscard]] double getAverageCategoryTime(const std::string& category) const;
@@ -44,6 +51,11 @@ namespace reina::tools {
         double lastFrameTime = 0;
         TimeEntries frameTime;
 
+        uint64_t pixelSamples = 0;
+        double samplesPerPixel = 0;
+        double samplingTime = 0;  // frames spent idle don't count towards the samples per second
+        bool sampledThisFrame = false;
+
         std::string lastCategory;
         double lastCategoryRecording = 0;
         std::map<std::string, TimeEntries> categoryTimes;
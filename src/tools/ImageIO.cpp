@@ -0,0 +1,299 @@
+#include "ImageIO.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    // the table driven CRC-32 of PNG chunks (ISO 3309)
+    const std::array<uint32_t, 256> CRC_TABLE = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t n = 0; n < table.size(); n++) {
+            uint32_t c = n;
+            for (int bit = 0; bit < 8; bit++) {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+
+        return table;
+    }();
+
+    void appendBigEndian(std::vector<uint8_t>& bytes, uint32_t value) {
+        bytes.push_back(static_cast<uint8_t>(value >> 24));
+        bytes.push_back(static_cast<uint8_t>(value >> 16));
+        bytes.push_back(static_cast<uint8_t>(value >> 8));
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    void writePngChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> chunk;
+        chunk.reserve(data.size() + 12);
+        appendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+
+        // over the type and the data, not the length
+        uint32_t crc = 0xffffffffu;
+        for (size_t i = 4; i < chunk.size(); i++) {
+            crc = CRC_TABLE[(crc ^ chunk[i]) & 0xff] ^ (crc >> 8);
+        }
+        appendBigEndian(chunk, crc ^ 0xffffffffu);
+
+        file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+    }
+
+    template<typename T>
+    void writeLittleEndian(std::ofstream& file, T value) {
+        // like the PFM writer, this assumes a little-endian host
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeExrAttribute(std::ofstream& file, const std::string& name, const std::string& type, const std::vector<uint8_t>& value) {
+        file.write(name.c_str(), static_cast<std::streamsize>(name.size() + 1));
+        file.write(type.c_str(), static_cast<std::streamsize>(type.size() + 1));
+        writeLittleEndian(file, static_cast<int32_t>(value.size()));
+        file.write(reinterpret_cast<const char*>(value.data()), static_cast<std::streamsize>(value.size()));
+    }
+
+    template<typename... T>
+    std::vector<uint8_t> exrValue(T... values) {
+        std::vector<uint8_t> bytes;
+        ([&] {
+            const auto* first = reinterpret_cast<const uint8_t*>(&values);
+            bytes.insert(bytes.end(), first, first + sizeof(values));
+        }(), ...);
+
+        return bytes;
+    }
+}
+
+void reina::tools::writePfm(const std::string& filepath, const HostImage& image) {
+    std::ofstream file(filepath, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open PFM file for writing at path: " + filepath);
+    }
+
+    // a negative scale means little-endian
+    file << "PF\n" << image.width << " " << image.height << "\n-1.0\n";
+
+    // PFM scanlines go from bottom to top
+    std::vector<float> row(image.width * 3);
+    for (uint32_t y = image.height; y-- > 0;) {
+        for (uint32_t x = 0; x < image.width; x++) {
+            const float* pixel = &image.pixels[(y * image.width + x) * 4];
+            row[x * 3] = pixel[0];
+            row[x * 3 + 1] = pixel[1];
+            row[x * 3 + 2] = pixel[2];
+        }
+
+        file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(float)));
+    }
+}
+
+reina::tools::HostImage reina::tools::readPfm(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open PFM file at path: " + filepath);
+    }
+
+    std::string magic;
+    HostImage image;
+    float scale;
+    file >> magic >> image.width >> image.height >> scale;
+    file.get();  // the single whitespace character before the raster
+
+    if (magic != "PF") {
+        throw std::runtime_error("Only color PFM files are supported: " + filepath);
+    }
+
+    if (scale > 0) {
+        throw std::runtime_error("Big-endian PFM files are not supported: " + filepath);
+    }
+
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height * 4);
+
+    std::vector<float> row(image.width * 3);
+    for (uint32_t y = image.height; y-- > 0;) {
+        if (!file.read(reinterpret_cast<char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(float)))) {
+            throw std::runtime_error("PFM file is truncated: " + filepath);
+        }
+
+        for (uint32_t x = 0; x < image.width; x++) {
+            float* pixel = &image.pixels[(y * image.width + x) * 4];
+            pixel[0] = row[x * 3];
+            pixel[1] = row[x * 3 + 1];
+            pixel[2] = row[x * 3 + 2];
+            pixel[3] = 1;
+        }
+    }
+
+    return image;
+}
+
+void reina::tools::resolveAccumulation(HostImage& image, const HostImage* compensation) {
+    if (compensation != nullptr && compensation->pixels.size() != image.pixels.size()) {
+        throw std::runtime_error("Compensation image size does not match the accumulation image");
+    }
+
+    for (size_t pixel = 0; pixel < image.pixels.size(); pixel += 4) {
+        float samples = std::max(image.pixels[pixel + 3], 1.0f);
+        for (size_t channel = 0; channel < 3; channel++) {
+            if (compensation != nullptr) {
+                image.pixels[pixel + channel] -= compensation->pixels[pixel + channel];
+            }
+            image.pixels[pixel + channel] /= samples;
+        }
+
+        image.pixels[pixel + 3] = 1.0f;
+    }
+}
+
+void reina::tools::writeExr(const std::string& filepath, const HostImage& image) {
+    std::ofstream file(filepath, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open EXR file for writing at path: " + filepath);
+    }
+
+    writeLittleEndian(file, static_cast<int32_t>(20000630));  // magic number
+    writeLittleEndian(file, static_cast<int32_t>(2));         // version 2, single part scanline
+
+    // channels in alphabetical order, as the format requires: 32 bit float, not linear, no subsampling
+    std::vector<uint8_t> channels;
+    for (const char* name : {"B", "G", "R"}) {
+        channels.insert(channels.end(), name, name + 2);
+        std::vector<uint8_t> properties = exrValue(int32_t{2}, uint8_t{0}, uint8_t{0}, uint8_t{0}, uint8_t{0}, int32_t{1}, int32_t{1});
+        channels.insert(channels.end(), properties.begin(), properties.end());
+    }
+    channels.push_back(0);
+
+    const auto maxX = static_cast<int32_t>(image.width) - 1;
+    const auto maxY = static_cast<int32_t>(image.height) - 1;
+    writeExrAttribute(file, "channels", "chlist", channels);
+    writeExrAttribute(file, "compression", "compression", {0});
+    writeExrAttribute(file, "dataWindow", "box2i", exrValue(int32_t{0}, int32_t{0}, maxX, maxY));
+    writeExrAttribute(file, "displayWindow", "box2i", exrValue(int32_t{0}, int32_t{0}, maxX, maxY));
+    writeExrAttribute(file, "lineOrder", "lineOrder", {0});  // increasing y, top to bottom like the image
+    writeExrAttribute(file, "pixelAspectRatio", "float", exrValue(1.0f));
+    writeExrAttribute(file, "screenWindowCenter", "v2f", exrValue(0.0f, 0.0f));
+    writeExrAttribute(file, "screenWindowWidth", "float", exrValue(1.0f));
+    file.put(0);
+
+    // without compression every block is one scanline: its y, its size and the channels one after another
+    const auto rowSize = static_cast<int32_t>(image.width * 3 * sizeof(float));
+    auto offset = static_cast<uint64_t>(file.tellp()) + static_cast<uint64_t>(image.height) * sizeof(uint64_t);
+    for (uint32_t y = 0; y < image.height; y++) {
+        writeLittleEndian(file, offset);
+        offset += 2 * sizeof(int32_t) + rowSize;
+    }
+
+    std::vector<float> row(image.width * 3);
+    for (uint32_t y = 0; y < image.height; y++) {
+        for (uint32_t x = 0; x < image.width; x++) {
+            const float* pixel = &image.pixels[(y * image.width + x) * 4];
+            row[x] = pixel[2];
+            row[image.width + x] = pixel[1];
+            row[image.width * 2 + x] = pixel[0];
+        }
+
+        writeLittleEndian(file, static_cast<int32_t>(y));
+        writeLittleEndian(file, rowSize);
+        file.write(reinterpret_cast<const char*>(row.data()), rowSize);
+    }
+}
+
+void reina::tools::writePng(const std::string& filepath, const HostImage& image, float exposure) {
+    std::ofstream file(filepath, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open PNG file for writing at path: " + filepath);
+    }
+
+    const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> header;
+    appendBigEndian(header, image.width);
+    appendBigEndian(header, image.height);
+    header.insert(header.end(), {8, 2, 0, 0, 0});  // 8 bit RGB, deflate, adaptive filtering, no interlacing
+    writePngChunk(file, "IHDR", header);
+
+    // every scanline starts with its filter type, 0 for none
+    std::vector<uint8_t> raw;
+    raw.reserve(static_cast<size_t>(image.height) * (image.width * 3 + 1));
+    for (uint32_t y = 0; y < image.height; y++) {
+        raw.push_back(0);
+        for (uint32_t x = 0; x < image.width; x++) {
+            const float* pixel = &image.pixels[(y * image.width + x) * 4];
+            for (int channel = 0; channel < 3; channel++) {
+                // the window shows the tonemapped values without sRGB encoding, see tonemap.apply.comp.glsl
+                raw.push_back(static_cast<uint8_t>(std::lround(tonemapACES(pixel[channel] * exposure) * 255.0f)));
+            }
+        }
+    }
+
+    // a zlib stream of stored deflate blocks, which hold at most 65535 bytes each
+    constexpr size_t MAX_STORED_BLOCK = 65535;
+    std::vector<uint8_t> zlib{0x78, 0x01};
+    zlib.reserve(raw.size() + raw.size() / MAX_STORED_BLOCK * 5 + 16);
+
+    for (size_t start = 0; start < raw.size() || start == 0; start += MAX_STORED_BLOCK) {
+        const size_t length = std::min(MAX_STORED_BLOCK, raw.size() - start);
+        const bool last = start + length >= raw.size();
+
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(length));
+        zlib.push_back(static_cast<uint8_t>(length >> 8));
+        zlib.push_back(static_cast<uint8_t>(~length));
+        zlib.push_back(static_cast<uint8_t>(~length >> 8));
+        zlib.insert(zlib.end(), raw.begin() + static_cast<std::ptrdiff_t>(start), raw.begin() + static_cast<std::ptrdiff_t>(start + length));
+
+        if (last) {
+            break;
+        }
+    }
+
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+
+    writePngChunk(file, "IDAT", zlib);
+    writePngChunk(file, "IEND", {});
+}
+
+void reina::tools::writeImage(const std::string& filepath, const HostImage& image, float exposure) {
+    std::string extension = std::filesystem::path(filepath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == ".png") {
+        writePng(filepath, image, exposure);
+    } else if (extension == ".exr") {
+        writeExr(filepath, image);
+    } else if (extension == ".pfm") {
+        writePfm(filepath, image);
+    } else {
+        throw std::runtime_error("Unknown image format, expected .png, .exr or .pfm: " + filepath);
+    }
+}
+
+float reina::tools::tonemapACES(float color) {
+    // keep in sync with tonemap.apply.comp.glsl
+    const float a = 2.51f;
+    const float b = 0.03f;
+    const float c = 2.43f;
+    const float d = 0.59f;
+    const float e = 0.14f;
+
+    return std::clamp((color * (a * color + b)) / (color * (c * color + d) + e), 0.0f, 1.0f);
+}
@@ -0,0 +1,60 @@
+#ifndef REINA_VK_IMAGEIO_H
+#define REINA_VK_IMAGEIO_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace reina::tools {
+    /**
+     * A CPU-side RGBA32F image, laid out row-major from the top-left corner, the same as the ray tracing image.
+     */
+    struct HostImage {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> pixels;  // 4 floats per pixel
+    };
+
+    /**
+     * Writes the RGB channels of the image as a little-endian PFM file. PFM is used since it stores the HDR values
+     * as-is, so references do not depend on the tonemapper.
+     */
+    void writePfm(const std::string& filepath, const HostImage& image);
+
+    /**
+     * Writes the image as an uncompressed scanline OpenEXR file with 32 bit float RGB channels, for HDR viewers and
+     * compositing tools that don't read PFM.
+     */
+    void writeExr(const std::string& filepath, const HostImage& image);
+
+    /**
+     * Writes the image as an 8 bit RGB PNG file, multiplied by the exposure and tonemapped with the same ACES curve as
+     * the window. The zlib stream uses stored blocks: encoding is a copy and two checksums, at the cost of file size.
+     */
+    void writePng(const std::string& filepath, const HostImage& image, float exposure = 1.0f);
+
+    /**
+     * Writes the image in the format of the file extension: .png, .exr or .pfm. Throws on other extensions. The
+     * exposure only applies to PNG, the HDR formats store the values as they are.
+     */
+    void writeImage(const std::string& filepath, const HostImage& image, float exposure = 1.0f);
+
+    /**
+     * The ACES filmic curve of tonemap.apply.comp.glsl, for one channel.
+     */
+    [[nodiscard]] float tonemapACES(float color);
+
+    /**
+     * Turns an image read back from the accumulation image (sums of samples in RGB, sample counts in alpha) into the
+     * mean of each pixel, with alpha 1. With COMPENSATED_ACCUMULATION, pass the compensation image read back with it,
+     * whose RGB is subtracted from the sums as in shaders/accumulation.h.glsl.
+     */
+    void resolveAccumulation(HostImage& image, const HostImage* compensation = nullptr);
+
+    /**
+     * Reads a color ("PF") PFM file. Alpha is set to 1.
+     */
+    [[nodiscard]] HostImage readPfm(const std::string& filepath);
+}
+
+#endif //REINA_VK_IMAGEIO_H
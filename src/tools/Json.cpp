@@ -0,0 +1,338 @@
+#include "Json.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    class JsonParser {
+    public:
+        explicit JsonParser(const std::string& text) : text(text) {}
+
+        reina::tools::JsonValue parseDocument() {
+            reina::tools::JsonValue value = parseValue();
+            skipWhitespace();
+
+            if (pos != text.size()) {
+                fail("unexpected trailing characters");
+            }
+
+            return value;
+        }
+
+    private:
+        const std::string& text;
+        size_t pos = 0;
+
+        [[noreturn]] void fail(const std::string& message) const {
+            // report the line since that's what a person editing a scene file needs
+            size_t line = 1;
+            for (size_t i = 0; i < pos && i < text.size(); i++) {
+                line += text[i] == '\n';
+            }
+
+            throw std::runtime_error("JSON error on line " + std::to_string(line) + ": " + message);
+        }
+
+        void skipWhitespace() {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+                pos++;
+            }
+        }
+
+        char peek() {
+            skipWhitespace();
+            if (pos >= text.size()) {
+                fail("unexpected end of file");
+            }
+
+            return text[pos];
+        }
+
+        void expect(char c) {
+            if (peek() != c) {
+                fail(std::string("expected '") + c + "'");
+            }
+
+            pos++;
+        }
+
+        bool consumeLiteral(const char* literal) {
+            size_t length = std::char_traits<char>::length(literal);
+            if (text.compare(pos, length, literal) != 0) {
+                return false;
+            }
+
+            pos += length;
+            return true;
+        }
+
+        reina::tools::JsonValue parseValue() {
+            char c = peek();
+
+            if (c == '{') {
+                return parseObject();
+            } else if (c == '[') {
+                return parseArray();
+            } else if (c == '"') {
+                return reina::tools::JsonValue{parseString()};
+            } else if (consumeLiteral("true")) {
+                return reina::tools::JsonValue{true};
+            } else if (consumeLiteral("false")) {
+                return reina::tools::JsonValue{false};
+            } else if (consumeLiteral("null")) {
+                return {};
+            }
+
+            return reina::tools::JsonValue{parseNumber()};
+        }
+
+        reina::tools::JsonValue parseObject() {
+            expect('{');
+            reina::tools::JsonValue::Object object;
+
+            if (peek() == '}') {
+                pos++;
+                return reina::tools::JsonValue{std::move(object)};
+            }
+
+            while (true) {
+                if (peek() != '"') {
+                    fail("expected a key");
+                }
+
+                std::string key = parseString();
+                expect(':');
+                object.emplace_back(std::move(key), parseValue());
+
+                if (peek() == ',') {
+                    pos++;
+                    continue;
+                }
+
+                expect('}');
+                return reina::tools::JsonValue{std::move(object)};
+            }
+        }
+
+        reina::tools::JsonValue parseArray() {
+            expect('[');
+            reina::tools::JsonValue::Array array;
+
+            if (peek() == ']') {
+                pos++;
+                return reina::tools::JsonValue{std::move(array)};
+            }
+
+            while (true) {
+                array.push_back(parseValue());
+
+                if (peek() == ',') {
+                    pos++;
+                    continue;
+                }
+
+                expect(']');
+                return reina::tools::JsonValue{std::move(array)};
+            }
+        }
+
+        std::string parseString() {
+            expect('"');
+            std::string result;
+
+            while (pos < text.size() && text[pos] != '"') {
+                char c = text[pos++];
+
+                if (c != '\\') {
+                    result += c;
+                    continue;
+                }
+
+                if (pos >= text.size()) {
+                    break;
+                }
+
+                char escaped = text[pos++];
+                switch (escaped) {
+                    case '"': result += '"'; break;
+                    case '\\': result += '\\'; break;
+                    case '/': result += '/'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'n': result += '\n'; break;
+                    case 'r': result += '\r'; break;
+                    case 't': result += '\t'; break;
+                    default: fail("unsupported escape sequence");  // \u is not needed for scene files
+                }
+            }
+
+            if (pos >= text.size()) {
+                fail("unterminated string");
+            }
+
+            pos++;  // closing quote
+            return result;
+        }
+
+        double parseNumber() {
+            const char* start = text.c_str() + pos;
+            char* end;
+            double number = std::strtod(start, &end);
+
+            if (end == start) {
+                fail("unexpected character");
+            }
+
+            pos += end - start;
+            return number;
+        }
+    };
+}
+
+reina::tools::JsonValue::JsonValue(bool value) : value(value) {}
+
+reina::tools::JsonValue::JsonValue(double value) : value(value) {}
+
+reina::tools::JsonValue::JsonValue(std::string value) : value(std::move(value)) {}
+
+reina::tools::JsonValue::JsonValue(Array value) : value(std::move(value)) {}
+
+reina::tools::JsonValue::JsonValue(Object value) : value(std::move(value)) {}
+
+bool reina::tools::JsonValue::isNull() const {
+    return std::holds_alternative<std::monostate>(value);
+}
+
+bool reina::tools::JsonValue::isNumber() const {
+    return std::holds_alternative<double>(value);
+}
+
+bool reina::tools::JsonValue::isString() const {
+    return std::holds_alternative<std::string>(value);
+}
+
+bool reina::tools::JsonValue::isArray() const {
+    return std::holds_alternative<Array>(value);
+}
+
+bool reina::tools::JsonValue::isObject() const {
+    return std::holds_alternative<Object>(value);
+}
+
+bool reina::tools::JsonValue::asBool() const {
+    if (!std::holds_alternative<bool>(value)) {
+        throw std::runtime_error("JSON value is not a boolean");
+    }
+
+    return std::get<bool>(value);
+}
+
+double reina::tools::JsonValue::asNumber() const {
+    if (!isNumber()) {
+        throw std::runtime_error("JSON value is not a number");
+    }
+
+    return std::get<double>(value);
+}
+
+float reina::tools::JsonValue::asFloat() const {
+    return static_cast<float>(asNumber());
+}
+
+uint32_t reina::tools::JsonValue::asUint() const {
+    double number = asNumber();
+    if (number < 0 || std::floor(number) != number) {
+        throw std::runtime_error("JSON value is not an unsigned integer");
+    }
+
+    return static_cast<uint32_t>(number);
+}
+
+const std::string& reina::tools::JsonValue::asString() const {
+    if (!isString()) {
+        throw std::runtime_error("JSON value is not a string");
+    }
+
+    return std::get<std::string>(value);
+}
+
+const reina::tools::JsonValue::Array& reina::tools::JsonValue::asArray() const {
+    if (!isArray()) {
+        throw std::runtime_error("JSON value is not an array");
+    }
+
+    return std::get<Array>(value);
+}
+
+const reina::tools::JsonValue::Object& reina::tools::JsonValue::asObject() const {
+    if (!isObject()) {
+        throw std::runtime_error("JSON value is not an object");
+    }
+
+    return std::get<Object>(value);
+}
+
+bool reina::tools::JsonValue::contains(const std::string& key) const {
+    if (!isObject()) {
+        return false;
+    }
+
+    for (const auto& [entryKey, entryValue] : std::get<Object>(value)) {
+        if (entryKey == key) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const reina::tools::JsonValue& reina::tools::JsonValue::operator[](const std::string& key) const {
+    for (const auto& [entryKey, entryValue] : asObject()) {
+        if (entryKey == key) {
+            return entryValue;
+        }
+    }
+
+    throw std::runtime_error("JSON object has no key \"" + key + "\"");
+}
+
+const reina::tools::JsonValue& reina::tools::JsonValue::operator[](size_t index) const {
+    const Array& array = asArray();
+    if (index >= array.size()) {
+        throw std::runtime_error("JSON array index out of range");
+    }
+
+    return array[index];
+}
+
+size_t reina::tools::JsonValue::size() const {
+    if (isObject()) {
+        return std::get<Object>(value).size();
+    }
+
+    return asArray().size();
+}
+
+reina::tools::JsonValue reina::tools::parseJson(const std::string& text) {
+    return JsonParser{text}.parseDocument();
+}
+
+reina::tools::JsonValue reina::tools::readJsonFile(const std::string& filepath) {
+    std::ifstream file(filepath);
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open JSON file at path: " + filepath);
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    try {
+        return parseJson(buffer.str());
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(filepath + ": " + e.what());
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef REINA_VK_JSON_H
+#define REINA_VK_JSON_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace reina::tools {
+    /**
+     * A minimal JSON document, enough for scene files. Accessors throw if the value has a different type or a key is
+     * missing, so malformed files fail loudly at load time.
+     */
+    class JsonValue {
+    public:
+        using Array = std::vector<JsonValue>;
+        using Object = std::vector<std::pair<std::string, JsonValue>>;  // in file order
+
+        JsonValue() = default;
+        explicit JsonValue(bool value);
+        explicit JsonValue(double value);
+        explicit JsonValue(std::string value);
+        explicit JsonValue(Array value);
+        explicit JsonValue(Object value);
+
+        [[nodiscard]] bool isNull() const;
+        [[nodiscard]] bool isNumber() const;
+        [[nodiscard]] bool isString() const;
+        [[nodiscard]] bool isArray() const;
+        [[nodiscard]] bool isObject() const;
+
+        [[nodiscard]] bool asBool() const;
+        [[nodiscard]] double asNumber() const;
+        [[nodiscard]] float asFloat() const;
+        [[nodiscard]] uint32_t asUint() const;
+        [[nodiscard]] const std::string& asString() const;
+        [[nodiscard]] const Array& asArray() const;
+        [[nodiscard]] const Object& asObject() const;
+
+        [[nodiscard]] bool contains(const std::string& key) const;
+        [[nodiscard]] const JsonValue& operator[](const std::string& key) const;
+        [[nodiscard]] const JsonValue& operator[](size_t index) const;
+        [[nodiscard]] size_t size() const;
+
+    private:
+        std::variant<std::monostate, bool, double, std::string, Array, Object> value;
+    };
+
+    [[nodiscard]] JsonValue parseJson(const std::string& text);
+    [[nodiscard]] JsonValue readJsonFile(const std::string& filepath);
+}
+
+#endif //REINA_VK_JSON_H
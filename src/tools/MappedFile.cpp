@@ -0,0 +1,113 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+reina::tools::MappedFile::MappedFile(const std::string& filepath) {
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file at path: " + filepath);
+    }
+
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to get the size of file at path: " + filepath);
+    }
+
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) {
+        return;  // empty files can't be mapped
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map file at path: " + filepath);
+    }
+
+    mappingHandle = mapping;
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (data == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map file at path: " + filepath);
+    }
+}
+
+reina::tools::MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+}
+
+#else
+
+reina::tools::MappedFile::MappedFile(const std::string& filepath) {
+    int file = open(filepath.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Failed to open file at path: " + filepath);
+    }
+
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) != 0) {
+        close(file);
+        throw std::runtime_error("Failed to get the size of file at path: " + filepath);
+    }
+
+    size = static_cast<size_t>(fileStat.st_size);
+    if (size == 0) {
+        close(file);
+        return;  // empty files can't be mapped
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);  // the mapping keeps its own reference to the file
+
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file at path: " + filepath);
+    }
+
+    // the file is read front to back, once
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mapping);
+}
+
+reina::tools::MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+#endif
+
+const char* reina::tools::MappedFile::getData() const {
+    return data;
+}
+
+size_t reina::tools::MappedFile::getSize() const {
+    return size;
+}
@@ -0,0 +1,34 @@
+#ifndef REINA_VK_MAPPEDFILE_H
+#define REINA_VK_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace reina::tools {
+    /**
+     * A read-only memory mapping of a whole file. The pages are loaded on demand by the OS, so even multi-GB files can
+     * be parsed without reading them into a buffer first.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& filepath);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const char* getData() const;
+        [[nodiscard]] size_t getSize() const;
+
+    private:
+        const char* data = nullptr;
+        size_t size = 0;
+
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+}
+
+#endif //REINA_VK_MAPPEDFILE_H
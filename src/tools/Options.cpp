@@ -0,0 +1,176 @@
+#include "Options.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef REINA_SHADER_SOURCE_DIR
+#define REINA_SHADER_SOURCE_DIR "../shaders"
+#endif
+
+namespace {
+    std::string_view nextArgument(int argc, char* argv[], int& i) {
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Missing value for argument " + std::string(argv[i]));
+        }
+
+        return argv[++i];
+    }
+
+    uint32_t parseUint(std::string_view value) {
+        try {
+            return static_cast<uint32_t>(std::stoul(std::string(value)));
+        } catch (const std::exception&) {
+            throw std::runtime_error("Expected an unsigned integer but got: " + std::string(value));
+        }
+    }
+
+    std::vector<std::string> splitList(std::string_view value) {
+        std::vector<std::string> items;
+        size_t start = 0;
+        while (start <= value.size()) {
+            size_t end = std::min(value.find(',', start), value.size());
+            if (end > start) {
+                items.emplace_back(value.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+
+        return items;
+    }
+
+    double parseDouble(std::string_view value) {
+        try {
+            return std::stod(std::string(value));
+        } catch (const std::exception&) {
+            throw std::runtime_error("Expected a number but got: " + std::string(value));
+        }
+    }
+}
+
+reina::tools::Options reina::tools::parseOptions(int argc, char* argv[]) {
+    Options options;
+    BenchOptions& bench = options.bench;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+
+        if (arg == "--scene") {
+            options.scenePath = nextArgument(argc, argv, i);
+        } else if (arg == "--no-mesh-optimization") {
+            options.optimizeMeshes = false;
+        } else if (arg == "--pipeline-cache") {
+            options.pipelineCacheDirectory = nextArgument(argc, argv, i);
+        } else if (arg == "--no-pipeline-cache") {
+            options.pipelineCacheDirectory.clear();
+        } else if (arg == "--shader-dev") {
+            options.shaderSourceDirectory = REINA_SHADER_SOURCE_DIR;
+        } else if (arg == "--shader-dir") {
+            options.shaderSourceDirectory = nextArgument(argc, argv, i);
+        } else if (arg == "--integrator") {
+            std::string_view integrator = nextArgument(argc, argv, i);
+            if (integrator == "megakernel") {
+                options.integrator = Integrator::Megakernel;
+            } else if (integrator == "wavefront") {
+                options.integrator = Integrator::Wavefront;
+            } else {
+                throw std::runtime_error("Unknown integrator: " + std::string(integrator));
+            }
+        } else if (arg == "--adaptive") {
+            options.adaptiveThreshold = static_cast<float>(parseDouble(nextArgument(argc, argv, i)));
+        } else if (arg == "--target-spp") {
+            options.targetSamples = parseUint(nextArgument(argc, argv, i));
+        } else if (arg == "--denoise") {
+            options.denoiseIterations = parseUint(nextArgument(argc, argv, i));
+        } else if (arg == "--no-reprojection") {
+            options.reprojection = false;
+        } else if (arg == "--no-preview") {
+            options.preview = false;
+        } else if (arg == "--aov") {
+            std::vector<std::string> aovs = splitList(nextArgument(argc, argv, i));
+            options.aovs.insert(options.aovs.end(), aovs.begin(), aovs.end());
+        } else if (arg == "--export-prefix") {
+            options.exportPrefix = nextArgument(argc, argv, i);
+        } else if (arg == "--export-format") {
+            options.exportFormat = nextArgument(argc, argv, i);
+            if (options.exportFormat != "png" && options.exportFormat != "exr" && options.exportFormat != "pfm") {
+                throw std::runtime_error("Unknown export format: " + options.exportFormat);
+            }
+        } else if (arg == "--export-every-frame") {
+            options.exportEveryFrame = true;
+        } else if (arg == "--frame-budget") {
+            options.frameBudgetMs = parseDouble(nextArgument(argc, argv, i));
+        } else if (arg == "--bench-obj") {
+            options.objBenchPath = nextArgument(argc, argv, i);
+        } else if (arg == "--bench") {
+            bench.enabled = true;
+        } else if (arg == "--width") {
+            bench.width = parseUint(nextArgument(argc, argv, i));
+        } else if (arg == "--height") {
+            bench.height = parseUint(nextArgument(argc, argv, i));
+        } else if (arg == "--spp") {
+            bench.samplesPerPixel = parseUint(nextArgument(argc, argv, i));
+        } else if (arg == "--seed") {
+            bench.seed = parseUint(nextArgument(argc, argv, i));
+        } else if (arg == "--check-every") {
+            bench.checkInterval = parseUint(nextArgument(argc, argv, i));
+        } else if (arg == "--reference") {
+            bench.referencePath = nextArgument(argc, argv, i);
+        } else if (arg == "--output") {
+            bench.outputPath = nextArgument(argc, argv, i);
+        } else if (arg == "--aov-output") {
+            bench.aovOutputPrefix = nextArgument(argc, argv, i);
+        } else if (arg == "--update-reference") {
+            bench.updateReference = true;
+        } else if (arg == "--target-rmse") {
+            bench.targetRmse = parseDouble(nextArgument(argc, argv, i));
+        } else if (arg == "--max-rmse") {
+            bench.maxRmse = parseDouble(nextArgument(argc, argv, i));
+        } else if (arg == "--max-time-to-target") {
+            bench.maxTimeToTarget = parseDouble(nextArgument(argc, argv, i));
+        } else {
+            throw std::runtime_error("Unknown argument: " + std::string(arg));
+        }
+    }
+
+    if (bench.width == 0 || bench.height == 0 || bench.samplesPerPixel == 0 || bench.checkInterval == 0) {
+        throw std::runtime_error("Benchmark width, height, spp and check interval must be greater than 0");
+    }
+
+    if (options.adaptiveThreshold < 0) {
+        throw std::runtime_error("--adaptive must not be negative");
+    }
+
+    if (options.adaptiveThreshold > 0 && options.integrator == Integrator::Wavefront) {
+        throw std::runtime_error("--adaptive is only supported by the megakernel integrator");
+    }
+
+    // the step of iteration i is 1 << i pixels, so past that the taps would only land outside any image
+    if (options.denoiseIterations > 10) {
+        throw std::runtime_error("--denoise takes at most 10 iterations");
+    }
+
+    // the features it filters with are written by the raygen shader that keeps a history
+    if (options.denoiseIterations > 0 && (options.adaptiveThreshold > 0 || options.integrator == Integrator::Wavefront)) {
+        throw std::runtime_error("--denoise is only supported by the megakernel integrator without --adaptive");
+    }
+
+    // the raygen shader writes them, the wavefront kernels don't
+    if (!options.aovs.empty() && options.integrator == Integrator::Wavefront) {
+        throw std::runtime_error("--aov is only supported by the megakernel integrator");
+    }
+
+    if (!bench.aovOutputPrefix.empty() && options.aovs.empty()) {
+        throw std::runtime_error("--aov-output requires --aov");
+    }
+
+    if (options.frameBudgetMs < 0) {
+        throw std::runtime_error("--frame-budget must not be negative");
+    }
+
+    if (bench.updateReference && bench.referencePath.empty()) {
+        throw std::runtime_error("--update-reference requires --reference");
+    }
+
+    return options;
+}
@@ -0,0 +1,62 @@
+#ifndef REINA_VK_OPTIONS_H
+#define REINA_VK_OPTIONS_H
+
+#include <string>
+#include <cstdint>
+#include <vector>
+
+namespace reina::tools {
+    /**
+     * Settings for the headless golden-image benchmark. See Bench.h.
+     */
+    struct BenchOptions {
+        bool enabled = false;
+        uint32_t width = 512;
+        uint32_t height = 512;
+        uint32_t samplesPerPixel = 1024;
+        uint32_t seed = 0;
+        uint32_t checkInterval = 128;  // in samples per pixel, how often the image is read back and compared
+
+        std::string referencePath;  // compare against this PFM file, if set
+        std::string outputPath;     // write the final image to this PFM file, if set
+        std::string aovOutputPrefix;  // write the enabled AOVs to <prefix>.<name>.pfm, if set
+        bool updateReference = false;  // overwrite the reference with the final image instead of comparing
+
+        double targetRmse = 0;       // record the time needed to reach this error. 0 disables
+        double maxRmse = 0;          // fail if the final error is above this. 0 disables
+        double maxTimeToTarget = 0;  // fail if reaching targetRmse took longer than this many seconds. 0 disables
+    };
+
+    enum class Integrator {
+        Megakernel,  // one trace rays call through the ray tracing pipeline
+        Wavefront    // compute passes with ray queries, see WavefrontIntegrator
+    };
+
+    struct Options {
+        std::string scenePath = "../scenes/demo.json";
+        std::string objBenchPath;  // if set, only compare the OBJ parsers on this file and exit
+        bool optimizeMeshes = true;
+        std::string pipelineCacheDirectory = ".";  // empty disables the pipeline cache
+        std::string shaderSourceDirectory;  // if set, the GLSL in it is compiled at runtime instead of using the embedded shaders
+        std::string shaderCacheDirectory = "shader_cache";
+        Integrator integrator = Integrator::Megakernel;
+        float adaptiveThreshold = 0;  // relative standard error at which pixels stop getting samples. 0 samples uniformly
+        uint32_t targetSamples = 4096;  // stop tracing a still view at this many samples per pixel, a count and not a noise level. 0 never stops
+        bool reprojection = true;  // keep the samples of surfaces that stay visible when the camera moves
+        uint32_t denoiseIterations = 0;  // a-trous iterations of the denoiser in the window, at most 10 (a 1024 pixel step). 0 disables it
+        bool preview = true;  // trace a cheap, low resolution image while the camera moves
+        std::vector<std::string> aovs;  // names of the first hit AOVs to write, see AovImages
+        std::string exportPrefix = "capture";  // captures are written to <prefix>.<n>.<format>, see ImageExporter
+        std::string exportFormat = "png";      // png, exr or pfm
+        bool exportEveryFrame = false;         // capture every frame instead of only on F12
+        double frameBudgetMs = 16;  // GPU time per frame the sample scheduler aims for. 0 is unlimited, as in the benchmark
+        BenchOptions bench;
+    };
+
+    /**
+     * Parses the command line. Throws if an argument is unknown or malformed.
+     */
+    [[nodiscard]] Options parseOptions(int argc, char* argv[]);
+}
+
+#endif //REINA_VK_OPTIONS_H
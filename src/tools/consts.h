@@ -10,7 +10,7 @@ namespace consts {
     };
 
     // array size + 1 with RT validation enabled
-    const std::array<const char*, 9> DEVICE_EXTENSIONS{
+    const std::array<const char*, 10> DEVICE_EXTENSIONS{
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME,
         VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
@@ -19,6 +19,7 @@ namespace consts {
         VK_KHR_SPIRV_1_4_EXTENSION_NAME,
         VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
         VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
+        VK_KHR_RAY_QUERY_EXTENSION_NAME,  // for the wavefront integrator
         VK_KHR_SHADER_NON_SEMANTIC_INFO_EXTENSION_NAME,  // for debug printf
 //        "VK_NV_ray_tracing_validation"
     };
@@ -28,6 +29,12 @@ namespace consts {
 #else
     const bool ENABLE_VALIDATION_LAYERS = true;
 #endif
+
+    // seconds between presents of a finished image, which wait for input instead of polling
+    const double IDLE_PRESENT_INTERVAL = 0.1;
+
+    // seconds after the last camera movement until the preview hands over to the full quality image
+    const double PREVIEW_HOLD_TIME = 0.15;
 }
 
 #endif //RAYGUN_VK_CONSTS_H
@@ -14,6 +14,7 @@
 #include "../core/DescriptorSet.h"
 #include "../core/PushConstants.h"
 #include "../core/Buffer.h"
+#include "ImageIO.h"
 
 // forward declaration
 namespace reina::graphics {
@@ -24,6 +25,7 @@ namespace vktools {
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        std::optional<uint32_t> transferFamily;  // a transfer only family if there is one, for readbacks next to rendering
 
         [[nodiscard]] bool isComplete() const;
     };
@@ -53,6 +55,15 @@ namespace vktools {
         VkDeviceSize stride;
     };
 
+    /**
+     * Shader indices into the list passed to createRtPipeline. Triangle hit groups only have a closest hit shader,
+     * procedural ones also have the intersection shader that tests their AABBs.
+     */
+    struct HitGroup {
+        uint32_t closestHitShader;
+        uint32_t intersectionShader = VK_SHADER_UNUSED_KHR;
+    };
+
     struct PipelineInfo {
         VkPipeline pipeline;
         VkPipelineLayout pipelineLayout;
@@ -88,21 +99,23 @@ namespace vktools {
     uint64_t getDeviceLocalMemory(VkPhysicalDevice device);
     bool isDeviceSuitable(VkPhysicalDevice device);
 
-    std::vector<VkFramebuffer> createSwapchainFramebuffers(VkDevice logicalDevice, VkRenderPass renderPass, VkExtent2D extent, const std::vector<VkImageView>& swapchainImageViews);
-    PipelineInfo createRasterizationPipeline(VkDevice logicalDevice, const reina::core::DescriptorSet& descriptorSet, VkRenderPass renderPass, const reina::graphics::Shader& vertexShader, const reina::graphics::Shader& fragmentShader);
-    VkRenderPass createRenderPass(VkDevice logicalDevice, VkFormat swapchainImageFormat);
-
     vktools::AccStructureInfo createTlas(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, const std::vector<reina::graphics::Instance>& instances);
     SyncObjects createSyncObjects(VkDevice logicalDevice);
     SbtSpacing calculateSbtSpacing(VkPhysicalDevice physicalDevice);
     reina::core::Buffer createSbt(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkPipeline rtPipeline, SbtSpacing spacing, uint32_t shaderGroups);
-    PipelineInfo createRtPipeline(VkDevice logicalDevice, const reina::core::DescriptorSet& descriptorSet, const std::vector<reina::graphics::Shader>& shaders, const reina::core::PushConstants& pushConstants);
-    VkImageView createRtImageView(VkDevice logicalDevice, VkImage rtImage);
-    ImageObjects createRtImage(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height);
+    PipelineInfo createRtPipeline(VkDevice logicalDevice, VkPipelineCache pipelineCache, const reina::core::DescriptorSet& descriptorSet, const std::vector<reina::graphics::Shader>& shaders, const std::vector<HitGroup>& hitGroups, const reina::core::PushConstants& pushConstants);
+    VkPipeline createComputePipeline(VkDevice logicalDevice, VkPipelineCache pipelineCache, VkPipelineLayout pipelineLayout, const reina::graphics::Shader& shader);
+    VkImageView createRtImageView(VkDevice logicalDevice, VkImage rtImage, VkFormat format = VK_FORMAT_R32G32B32A32_SFLOAT);
+    ImageObjects createRtImage(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height, VkFormat format = VK_FORMAT_R32G32B32A32_SFLOAT);
+    reina::tools::HostImage readRtImage(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, VkCommandPool cmdPool, VkQueue queue, VkImage rtImage, uint32_t width, uint32_t height);
+
+    // recording helpers for the passes, on the single mip and layer color images createRtImage makes
+    void memoryBarrier(VkCommandBuffer cmdBuffer, VkPipelineStageFlags srcStages, VkAccessFlags srcAccess, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
+    VkImageMemoryBarrier imageBarrier(VkImage image, VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkImageLayout oldLayout, VkImageLayout newLayout);
+    void copyImage(VkCommandBuffer cmdBuffer, VkImage source, VkImage destination, uint32_t width, uint32_t height);  // both in the general layout
 
     VkCommandBuffer createCommandBuffer(VkDevice logicalDevice, VkCommandPool commandPool);
     VkCommandPool createCommandPool(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkSurfaceKHR surface);
-    std::vector<VkImageView> createSwapchainImageViews(VkDevice logicalDevice, VkFormat swapchainImageFormat, std::vector<VkImage> swapchainImages);
     SwapchainObjects createSwapchain(VkSurfaceKHR surface, VkPhysicalDevice physicalDevice, VkDevice logicalDevice, int windowWidth, int windowHeight);
     VkDevice createLogicalDevice(VkSurfaceKHR surface, VkPhysicalDevice physicalDevice);
     VkPhysicalDevice pickPhysicalDevice(VkInstance instance, VkSurfaceKHR surface);
@@ -3,7 +3,9 @@
 #include <stdexcept>
 #include <iostream>
 
-reina::window::Window::Window(int width, int height) {
+reina::window::Window::Window(int width, int height, bool headless) {
+    glfwInitHint(GLFW_PLATFORM, headless ? GLFW_PLATFORM_NULL : GLFW_ANY_PLATFORM);
+
     if (glfwInit() != GLFW_TRUE) {  // todo: should glfw init for every object or just once?
         throw std::runtime_error("Cannot init GLFW");
     }
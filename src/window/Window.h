@@ -10,7 +10,11 @@ namespace reina::window {
         int width{}, height{};
 
     public:
-        Window(int width, int height);
+        /**
+         * @param headless If true, GLFW uses its null platform: the window is never shown and needs no display, so
+         *                 there is no surface to present to either.
+         */
+        Window(int width, int height, bool headless = false);
 
         [[nodiscard]] int getWidth() const;
         [[nodiscard]] int getHeight() const;
@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "graphics/SampleScheduler.h"
+
+namespace {
+    constexpr uint32_t WIDTH = 100;
+    constexpr uint32_t HEIGHT = 100;
+    constexpr uint64_t PIXELS = static_cast<uint64_t>(WIDTH) * HEIGHT;
+    constexpr double FRAME_BUDGET = 0.016;
+
+    int failures = 0;
+
+    void check(bool condition, const char* description) {
+        if (!condition) {
+            std::cerr << "FAILED: " << description << "\n";
+            failures++;
+        }
+    }
+
+    // a full frame of one sample per pixel in 10 ms is a throughput of 1e6 pixel samples per second, so 1.6 samples
+    // per pixel fit the budget and the scheduler plans 1
+    reina::graphics::SampleScheduler measuredScheduler() {
+        reina::graphics::SampleScheduler scheduler{WIDTH, HEIGHT, FRAME_BUDGET, false, 0};
+        reina::graphics::SamplePlan plan = scheduler.next();
+        scheduler.reportTime(0.01, PIXELS * plan.samplesPerPixel);
+        return scheduler;
+    }
+
+    void testFullFrame() {
+        reina::graphics::SampleScheduler scheduler = measuredScheduler();
+        check(scheduler.next().samplesPerPixel == 1, "a full frame keeps the throughput it measured");
+    }
+
+    void testAdaptiveWorkList() {
+        reina::graphics::SampleScheduler scheduler = measuredScheduler();
+
+        // the plan covers the whole image, but adaptive sampling only traced the 1% of pixels on its work list, at the
+        // same throughput. counting the planned samples would make the throughput look 100 times higher
+        reina::graphics::SamplePlan plan = scheduler.next();
+        uint64_t tracedPixelSamples = PIXELS / 100 * plan.samplesPerPixel;
+        scheduler.reportTime(static_cast<double>(tracedPixelSamples) / 1e6, tracedPixelSamples);
+
+        check(scheduler.next().samplesPerPixel == 1, "a frame of a 1% work list doesn't multiply the throughput");
+    }
+
+    void testNothingTraced() {
+        reina::graphics::SampleScheduler scheduler = measuredScheduler();
+        (void) scheduler.next();
+        scheduler.reportTime(0.001, 0);
+        check(scheduler.next().samplesPerPixel == 1, "a frame that traced nothing doesn't change the throughput");
+    }
+}
+
+int main() {
+    testFullFrame();
+    testAdaptiveWorkList();
+    testNothingTraced();
+
+    if (failures > 0) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "SampleScheduler tests passed\n";
+    return EXIT_SUCCESS;
+}